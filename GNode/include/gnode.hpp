@@ -8,8 +8,18 @@
 
 #pragma once
 
+#include "gnode/buffer_pool.hpp"
+#include "gnode/cancellation.hpp"
 #include "gnode/data.hpp"
+#include "gnode/disk_cache.hpp"
+#include "gnode/executor.hpp"
 #include "gnode/graph.hpp"
+#include "gnode/handle.hpp"
 #include "gnode/link.hpp"
 #include "gnode/node.hpp"
+#include "gnode/parameter_table.hpp"
 #include "gnode/port.hpp"
+#include "gnode/result_cache.hpp"
+#include "gnode/static_node.hpp"
+#include "gnode/tiling.hpp"
+#include "gnode/type_id.hpp"
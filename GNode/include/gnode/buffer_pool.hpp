@@ -0,0 +1,236 @@
+/* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+
+/**
+ * @file buffer_pool.hpp
+ * @author Otto Link (otto.link.bv@gmail.com)
+ * @brief Defines the `BufferPool` class, a pool of aligned memory blocks, and
+ * the `PoolAllocator` standard allocator drawing from it.
+ * @date 2023-08-07
+ *
+ * @copyright Copyright (c) 2023 Otto Link. Distributed under the terms of the
+ * GNU General Public License. See the file LICENSE for the full license.
+ */
+
+#pragma once
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+namespace gnode
+{
+
+/**
+ * @struct BufferPoolStats
+ * @brief Usage statistics of a `BufferPool`.
+ */
+struct BufferPoolStats
+{
+  size_t allocations = 0;  ///< Number of blocks handed out.
+  size_t reuses = 0;       ///< Number of blocks taken from the free lists.
+  size_t bytes_in_use = 0; ///< Memory of the blocks handed out.
+  size_t bytes_cached = 0; ///< Memory of the blocks kept in the free lists.
+};
+
+/**
+ * @class BufferPool
+ * @brief Pool of memory blocks aligned on cache lines, recycled through free
+ * lists of size classes.
+ *
+ * Requests are rounded up to a size class (powers of two up to 4 KiB, then
+ * four classes per power of two), so that the buffers of nodes computing
+ * again, resized to the same size at each update, are served from the free
+ * lists rather than by the system allocator. Blocks are aligned on
+ * `alignment` bytes and never share a cache line. Freed blocks are kept up to
+ * the cache limit.
+ *
+ * On Linux, blocks of at least `huge_page_size` bytes can be backed by
+ * transparent huge pages (see `set_huge_pages`).
+ *
+ * The pool is safe to use from the threads of a parallel executor.
+ */
+class BufferPool
+{
+public:
+  /**
+   * @brief Block alignment, a cache line and the width of the widest SIMD
+   * registers.
+   */
+  static constexpr size_t alignment = 64;
+
+  /**
+   * @brief Huge page size, see `set_huge_pages`.
+   */
+  static constexpr size_t huge_page_size = size_t(2) << 20;
+
+  /**
+   * @brief Constructs a pool.
+   *
+   * @param cache_limit Maximum memory kept in the free lists, in bytes.
+   */
+  explicit BufferPool(size_t cache_limit = size_t(256) << 20)
+      : cache_limit(cache_limit)
+  {
+  }
+
+  /**
+   * @brief Destroys the pool, releasing the blocks of the free lists (the
+   * blocks still in use must not be deallocated afterwards).
+   */
+  ~BufferPool();
+
+  BufferPool(const BufferPool &) = delete;
+  BufferPool &operator=(const BufferPool &) = delete;
+
+  /**
+   * @brief Allocate a block.
+   *
+   * @param bytes Requested size, in bytes.
+   * @return void* Block aligned on `alignment` bytes.
+   * @throw std::bad_alloc If the memory cannot be allocated.
+   */
+  void *allocate(size_t bytes);
+
+  /**
+   * @brief Give back a block to the pool.
+   *
+   * @param p Block returned by `allocate`.
+   * @param bytes Size requested to `allocate`, in bytes.
+   */
+  void deallocate(void *p, size_t bytes) noexcept;
+
+  /**
+   * @brief Get the pool used by `PoolAllocator`, shared by the whole process.
+   */
+  static BufferPool &get_default();
+
+  /**
+   * @brief Get the maximum memory kept in the free lists, in bytes.
+   */
+  size_t get_cache_limit() const;
+
+  /**
+   * @brief Get the size class of a request, in bytes.
+   *
+   * @param bytes Requested size, in bytes.
+   */
+  static size_t get_class_size(size_t bytes);
+
+  /**
+   * @brief Get the usage statistics.
+   */
+  BufferPoolStats get_stats() const;
+
+  /**
+   * @brief Checks whether large blocks are backed by huge pages, see
+   * `set_huge_pages`.
+   */
+  bool is_huge_pages() const;
+
+  /**
+   * @brief Set the maximum memory kept in the free lists, the blocks beyond
+   * being released.
+   *
+   * @param new_limit Limit, in bytes.
+   */
+  void set_cache_limit(size_t new_limit);
+
+  /**
+   * @brief Back the blocks of at least `huge_page_size` bytes by transparent
+   * huge pages, reducing TLB misses on large buffers (Linux only, ignored
+   * elsewhere). Only applies to the blocks allocated afterwards.
+   *
+   * @param new_state Activation flag.
+   */
+  void set_huge_pages(bool new_state);
+
+  /**
+   * @brief Release all the blocks of the free lists.
+   */
+  void trim();
+
+private:
+  /**
+   * @brief Release blocks of the free lists, the largest classes first, until
+   * the cached memory fits in a limit (lock held).
+   */
+  void shrink(size_t limit);
+
+  /**
+   * @brief Free blocks by size class.
+   */
+  std::unordered_map<size_t, std::vector<void *>> free_lists;
+
+  /**
+   * @brief Maximum memory kept in the free lists, in bytes.
+   */
+  size_t cache_limit;
+
+  /**
+   * @brief Huge pages flag.
+   */
+  bool huge_pages = false;
+
+  /**
+   * @brief Usage statistics.
+   */
+  BufferPoolStats stats;
+
+  /**
+   * @brief Guards the free lists and the statistics.
+   */
+  mutable std::mutex mutex;
+};
+
+/**
+ * @brief Standard allocator drawing from the default `BufferPool`.
+ *
+ * The allocator is stateless, all the instances comparing equal, so that
+ * containers using it can be moved from one `Data<T>` to another without
+ * copying their elements (see `Node::take_input`).
+ *
+ * @tparam T The element type.
+ */
+template <typename T> struct PoolAllocator
+{
+  static_assert(alignof(T) <= BufferPool::alignment,
+                "PoolAllocator: over-aligned type");
+
+  using value_type = T;
+
+  PoolAllocator() noexcept = default;
+
+  template <typename U> PoolAllocator(const PoolAllocator<U> &) noexcept {}
+
+  T *allocate(size_t n)
+  {
+    if (n > std::numeric_limits<size_t>::max() / sizeof(T))
+      throw std::bad_array_new_length();
+
+    return static_cast<T *>(BufferPool::get_default().allocate(n * sizeof(T)));
+  }
+
+  void deallocate(T *p, size_t n) noexcept
+  {
+    BufferPool::get_default().deallocate(p, n * sizeof(T));
+  }
+
+  template <typename U> bool operator==(const PoolAllocator<U> &) const noexcept
+  {
+    return true;
+  }
+};
+
+/**
+ * @brief Vector whose elements are allocated from the default `BufferPool`,
+ * aligned for SIMD and recycled across updates.
+ *
+ * @tparam T The element type.
+ */
+template <typename T> using PooledVector = std::vector<T, PoolAllocator<T>>;
+
+} // namespace gnode
@@ -0,0 +1,50 @@
+/* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+
+/**
+ * @file cancellation.hpp
+ * @author Otto Link (otto.link.bv@gmail.com)
+ * @brief Defines the `CancellationToken` class used to stop a graph update.
+ * @date 2023-08-07
+ *
+ * @copyright Copyright (c) 2023 Otto Link. Distributed under the terms of the
+ * GNU General Public License. See the file LICENSE for the full license.
+ */
+
+#pragma once
+#include <atomic>
+
+namespace gnode
+{
+
+/**
+ * @class CancellationToken
+ * @brief Flag shared between an update and the code requesting its
+ * cancellation.
+ *
+ * The graph checks the token before each node update, while long node
+ * computations can poll it through `Node::is_cancel_requested` to return
+ * early.
+ */
+class CancellationToken
+{
+public:
+  /**
+   * @brief Request the cancellation.
+   */
+  void cancel() { this->cancelled.store(true, std::memory_order_relaxed); }
+
+  /**
+   * @brief Checks whether the cancellation has been requested.
+   */
+  bool is_cancelled() const
+  {
+    return this->cancelled.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<bool> cancelled = false; ///< Cancellation flag.
+};
+
+} // namespace gnode
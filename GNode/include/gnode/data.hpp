@@ -15,28 +15,285 @@
  */
 
 #pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <istream>
+#include <iterator>
 #include <memory>
+#include <optional>
+#include <ostream>
 #include <string>
+#include <type_traits>
 #include <typeinfo>
 
+#include "gnode/buffer_pool.hpp"
+#include "gnode/type_id.hpp"
+
 namespace gnode
 {
 
+/**
+ * @brief 64-bit hash of a byte buffer (xxHash64 algorithm).
+ *
+ * The buffer is read in 8-byte words, spread over four independent lanes for
+ * buffers of 32 bytes and more, so that large buffers (e.g. rasters hashed
+ * for the result caches and the early cutoff) are hashed at memory speed.
+ *
+ * @param p_bytes Pointer to the buffer.
+ * @param size Buffer size in bytes.
+ * @param seed Hash to continue from, to hash several buffers in a row.
+ * @return The hash value.
+ */
+inline uint64_t hash_bytes(const void *p_bytes, size_t size, uint64_t seed = 0)
+{
+  constexpr uint64_t prime1 = 0x9e3779b185ebca87ull;
+  constexpr uint64_t prime2 = 0xc2b2ae3d27d4eb4full;
+  constexpr uint64_t prime3 = 0x165667b19e3779f9ull;
+  constexpr uint64_t prime4 = 0x85ebca77c2b2ae63ull;
+  constexpr uint64_t prime5 = 0x27d4eb2f165667c5ull;
+
+  auto read64 = [](const unsigned char *p)
+  {
+    uint64_t word;
+    std::memcpy(&word, p, sizeof(uint64_t));
+    return word;
+  };
+
+  auto round = [](uint64_t acc, uint64_t word)
+  { return std::rotl(acc + word * prime2, 31) * prime1; };
+
+  auto merge = [&](uint64_t hash, uint64_t acc)
+  { return (hash ^ round(0, acc)) * prime1 + prime4; };
+
+  const auto *p = static_cast<const unsigned char *>(p_bytes);
+  const auto *p_end = p + size;
+  uint64_t    hash;
+
+  if (size >= 32)
+  {
+    uint64_t acc1 = seed + prime1 + prime2;
+    uint64_t acc2 = seed + prime2;
+    uint64_t acc3 = seed;
+    uint64_t acc4 = seed - prime1;
+
+    for (; p + 32 <= p_end; p += 32)
+    {
+      acc1 = round(acc1, read64(p));
+      acc2 = round(acc2, read64(p + 8));
+      acc3 = round(acc3, read64(p + 16));
+      acc4 = round(acc4, read64(p + 24));
+    }
+
+    hash = std::rotl(acc1, 1) + std::rotl(acc2, 7) + std::rotl(acc3, 12) +
+           std::rotl(acc4, 18);
+    hash = merge(merge(merge(merge(hash, acc1), acc2), acc3), acc4);
+  }
+  else
+    hash = seed + prime5;
+
+  hash += size;
+
+  for (; p + 8 <= p_end; p += 8)
+    hash = std::rotl(hash ^ round(0, read64(p)), 27) * prime1 + prime4;
+
+  if (p + 4 <= p_end)
+  {
+    uint32_t word;
+    std::memcpy(&word, p, sizeof(uint32_t));
+    hash = std::rotl(hash ^ (word * prime1), 23) * prime2 + prime3;
+    p += 4;
+  }
+
+  for (; p < p_end; ++p)
+    hash = std::rotl(hash ^ (*p * prime5), 11) * prime1;
+
+  // final avalanche
+  hash ^= hash >> 33;
+  hash *= prime2;
+  hash ^= hash >> 29;
+  hash *= prime3;
+  hash ^= hash >> 32;
+
+  return hash;
+}
+
+/**
+ * @brief Whether values of type T are hashed byte-wise by `DataHasher`:
+ * arithmetic types and types with a unique object representation (no padding),
+ * pointers excluded since equal addresses do not imply equal pointees.
+ *
+ * @tparam T The value type.
+ */
+template <typename T>
+inline constexpr bool is_hashable_bytes_v =
+    (std::is_arithmetic_v<T> || std::has_unique_object_representations_v<T>) &&
+    !std::is_pointer_v<T> && !std::is_member_pointer_v<T>;
+
+/**
+ * @brief Hash of a value of type T, used to detect unchanged node outputs.
+ *
+ * Hashing is opt-in: only the types satisfying `is_hashable_bytes_v` and the
+ * contiguous containers of such elements (`std::vector<float>`,
+ * `std::string`...) are hashed byte-wise. Other types, in particular pointers
+ * and smart pointers whose pointee may change behind the same address, return
+ * `std::nullopt` and are always considered as changed. The trait can be
+ * specialized for custom types, as can be needed for structs holding
+ * pointers, which have a unique object representation too.
+ *
+ * @tparam T The data type.
+ */
+template <typename T> struct DataHasher
+{
+  static std::optional<uint64_t> hash(const T &value)
+  {
+    if constexpr (is_hashable_bytes_v<T>)
+      return hash_bytes(&value, sizeof(T));
+    else if constexpr (requires {
+                         requires is_hashable_bytes_v<
+                             std::remove_cvref_t<decltype(*std::data(value))>>;
+                         std::size(value);
+                       })
+      return hash_bytes(std::data(value),
+                        std::size(value) * sizeof(*std::data(value)));
+    else
+      return std::nullopt;
+  }
+};
+
+/**
+ * @brief Memory footprint of a value of type T, used for the cache budgets.
+ *
+ * Contiguous containers account for their elements, other types for their
+ * object size only. The trait can be specialized for custom types owning
+ * memory.
+ *
+ * @tparam T The data type.
+ */
+template <typename T> struct DataSizer
+{
+  static size_t size(const T &value)
+  {
+    if constexpr (requires { std::size(value) * sizeof(*std::data(value)); })
+      return sizeof(T) + std::size(value) * sizeof(*std::data(value));
+    else
+      return sizeof(T);
+  }
+};
+
+/**
+ * @brief Binary serialization of a value of type T, used by the disk cache.
+ *
+ * Values satisfying `is_hashable_bytes_v` are written as raw bytes, and
+ * resizable contiguous containers of such elements (`std::vector<float>`,
+ * `std::string`...) as their size followed by their elements. Other types, in
+ * particular pointers and structs holding pointers whose addresses would not
+ * survive the process, are not serialized unless the trait is specialized,
+ * both functions returning false.
+ *
+ * @tparam T The data type.
+ */
+template <typename T> struct DataSerializer
+{
+  static bool serialize(const T &value, std::ostream &os)
+  {
+    if constexpr (is_hashable_bytes_v<T>)
+    {
+      os.write(reinterpret_cast<const char *>(&value), sizeof(T));
+      return static_cast<bool>(os);
+    }
+    else if constexpr (is_resizable_buffer)
+    {
+      const uint64_t size = std::size(value);
+
+      os.write(reinterpret_cast<const char *>(&size), sizeof(uint64_t));
+      os.write(reinterpret_cast<const char *>(std::data(value)),
+               size * sizeof(*std::data(value)));
+      return static_cast<bool>(os);
+    }
+    else
+      return false;
+  }
+
+  static bool deserialize(std::istream &is, T &value)
+  {
+    if constexpr (is_hashable_bytes_v<T>)
+    {
+      is.read(reinterpret_cast<char *>(&value), sizeof(T));
+      return static_cast<bool>(is);
+    }
+    else if constexpr (is_resizable_buffer)
+    {
+      uint64_t size = 0;
+
+      if (!is.read(reinterpret_cast<char *>(&size), sizeof(uint64_t)) ||
+          size > value.max_size())
+        return false;
+
+      // the buffer grows with the data actually read, a corrupted size
+      // failing on the end of the stream instead of allocating it upfront
+      constexpr size_t element_size = sizeof(*std::data(value));
+      constexpr size_t chunk_size = std::max<size_t>(1,
+                                                     (1 << 20) / element_size);
+
+      value.resize(0);
+
+      for (size_t count = 0; count < size;)
+      {
+        const size_t n = std::min<uint64_t>(chunk_size, size - count);
+
+        value.resize(count + n);
+        if (!is.read(reinterpret_cast<char *>(std::data(value)) +
+                         count * element_size,
+                     n * element_size))
+          return false;
+
+        count += n;
+      }
+      return true;
+    }
+    else
+      return false;
+  }
+
+private:
+  static constexpr bool is_resizable_buffer = requires(T &value) {
+    requires is_hashable_bytes_v<
+        std::remove_cvref_t<decltype(*std::data(value))>>;
+    value.resize(std::size(value));
+  };
+};
+
+/**
+ * @brief Residency state of some data, see `BaseData::drop`.
+ */
+enum class DataResidency
+{
+  RESIDENT, ///< Value in memory.
+  DROPPED,  ///< Value released, to be recomputed.
+  SPILLED   ///< Value written to a file and released.
+};
+
 /**
  * @brief Abstract base class representing generic data with type information.
  *
  * The BaseData class provides a common interface for handling data of different
- * types. It stores a type identifier as a string and requires derived classes
- * to implement a method to retrieve a pointer to the stored value.
+ * types. It stores an interned type identifier (see `TypeId`) and requires
+ * derived classes to implement a method to retrieve a pointer to the stored
+ * value.
  */
 class BaseData
 {
 public:
   /**
    * @brief Constructs a BaseData object with the specified type.
-   * @param type A string representing the type of the data.
+   * @param type_id The identifier of the type of the data.
    */
-  explicit BaseData(std::string type) : type(type) {}
+  explicit BaseData(TypeId type_id) : type_id(type_id) {}
 
   /**
    * @brief Virtual destructor for BaseData.
@@ -51,14 +308,60 @@ public:
    */
   bool is_same_type(const BaseData &data) const
   {
-    return this->get_type() == data.get_type();
+    return this->type_id == data.type_id;
   }
 
   /**
-   * @brief Retrieves the type of the data as a string.
+   * @brief Retrieves the type of the data as a string (see `get_type_name`).
    * @return A string representing the type of the data.
    */
-  const std::string &get_type() const { return this->type; }
+  const std::string &get_type() const { return get_type_name(this->type_id); }
+
+  /**
+   * @brief Retrieves the identifier of the type of the data.
+   * @return The type identifier.
+   */
+  TypeId get_type_id() const { return this->type_id; }
+
+  /**
+   * @brief Retrieves a hash of the stored value.
+   * @return The hash, or `std::nullopt` if the value cannot be hashed.
+   */
+  virtual std::optional<uint64_t> get_hash() const { return std::nullopt; }
+
+  /**
+   * @brief Creates a copy of the data.
+   * @return The copy, or nullptr if the value cannot be copied.
+   */
+  virtual std::shared_ptr<BaseData> clone() const { return nullptr; }
+
+  /**
+   * @brief Copies the value of another data object of the same type, the data
+   * object itself being kept (the ports pointing to it are left untouched).
+   * @param data The data to copy from.
+   * @return True if the value has been copied.
+   */
+  virtual bool copy_from(const BaseData & /* data */) { return false; }
+
+  /**
+   * @brief Retrieves the memory footprint of the data.
+   * @return Size in bytes.
+   */
+  virtual size_t get_byte_size() const { return 0; }
+
+  /**
+   * @brief Writes the value to a binary stream.
+   * @param os Output stream.
+   * @return True if the value has been written.
+   */
+  virtual bool serialize(std::ostream & /* os */) const { return false; }
+
+  /**
+   * @brief Reads the value from a binary stream, see `serialize`.
+   * @param is Input stream.
+   * @return True if the value has been read.
+   */
+  virtual bool deserialize(std::istream & /* is */) { return false; }
 
   /**
    * @brief Pure virtual method to retrieve a pointer to the stored value.
@@ -67,10 +370,107 @@ public:
   virtual const void *get_value_ptr() const = 0;
   virtual void       *get_value_ptr() = 0; ///< @overload
 
+  /**
+   * @brief Release the value to free memory, the value being brought back by
+   * the restore hook on the next access.
+   *
+   * @param hook Restore hook, expected to recompute the value and to call
+   * `set_resident`.
+   * @return True if the value has been released.
+   */
+  bool drop(std::function<void()> hook);
+
+  /**
+   * @brief Make sure the value is in memory, running the restore hook if the
+   * value has been dropped or spilled.
+   */
+  void ensure_resident() const
+  {
+    if (this->residency.load(std::memory_order_acquire) !=
+            DataResidency::RESIDENT &&
+        this->restore_hook)
+      this->restore_hook();
+  }
+
+  /**
+   * @brief Retrieves the residency state of the data.
+   */
+  DataResidency get_residency() const
+  {
+    return this->residency.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Checks whether the data is pinned in memory, see `set_pinned`.
+   */
+  bool is_pinned() const { return this->pinned; }
+
+  /**
+   * @brief Read back a spilled value, see `spill`.
+   * @return True if the value has been read.
+   */
+  bool reload();
+
+  /**
+   * @brief Prevent the data from being dropped or spilled.
+   * @param new_state Pin state.
+   */
+  void set_pinned(bool new_state) { this->pinned = new_state; }
+
+  /**
+   * @brief Flag the value as in memory, the spill file being removed (the
+   * value of dropped data being the default value of its type until
+   * recomputed).
+   */
+  void set_resident();
+
+  /**
+   * @brief Write the value to a file and release it, the value being brought
+   * back by the restore hook on the next access.
+   *
+   * @param path Spill file.
+   * @param hook Restore hook, expected to call `reload`.
+   * @return True if the value has been written and released.
+   */
+  bool spill(const std::filesystem::path &path, std::function<void()> hook);
+
+protected:
+  /**
+   * @brief Release the memory held by the value, reset to the default value
+   * of its type.
+   * @return True if the value has been released.
+   */
+  virtual bool release() { return false; }
+
 private:
-  std::string type; ///< A string representing the type of the data.
+  TypeId type_id; ///< The identifier of the type of the data.
+
+  /**
+   * @brief Residency state.
+   */
+  std::atomic<DataResidency> residency = DataResidency::RESIDENT;
+
+  /**
+   * @brief Hook bringing back a dropped or spilled value.
+   */
+  std::function<void()> restore_hook;
+
+  /**
+   * @brief Spill file of a spilled value.
+   */
+  std::filesystem::path spill_path;
+
+  /**
+   * @brief Pin state.
+   */
+  bool pinned = false;
 };
 
+template <typename T> class Data; // forward
+
+template <typename T, typename... Args>
+std::shared_ptr<Data<T>> make_data(Args &&...args); // forward
+
 /**
  * @brief Template class for holding data of a specific type.
  *
@@ -91,13 +491,13 @@ public:
    * @param args Arguments forwarded to the constructor of T to initialize the
    * value.
    *
-   * This constructor initializes the base class `BaseData` with the type name
-   * of `T` using `typeid(T).name()`. It then constructs `this->value` of type
-   * `T` using the forwarded arguments `args`.
+   * This constructor initializes the base class `BaseData` with the type
+   * identifier of `T` (see `get_type_id`). It then constructs `this->value`
+   * of type `T` using the forwarded arguments `args`.
    */
   template <typename... Args>
   explicit Data(Args &&...args)
-      : BaseData(typeid(T).name()), value(std::forward<Args>(args)...)
+      : BaseData(gnode::get_type_id<T>()), value(std::forward<Args>(args)...)
   {
   }
 
@@ -105,17 +505,137 @@ public:
    * @brief Retrieves a reference to the stored value.
    * @return A pointer to the stored value.
    */
-  T *get_value_ref() { return &this->value; }
+  T *get_value_ref()
+  {
+    this->ensure_resident();
+    return &this->value;
+  }
+
+  /**
+   * @brief Retrieves a hash of the stored value, see `DataHasher`.
+   * @return The hash, or `std::nullopt` if the value cannot be hashed.
+   */
+  std::optional<uint64_t> get_hash() const override
+  {
+    this->ensure_resident();
+    return DataHasher<T>::hash(this->value);
+  }
+
+  /**
+   * @brief Creates a copy of the data.
+   * @return The copy, or nullptr if T is not copy constructible.
+   */
+  std::shared_ptr<BaseData> clone() const override
+  {
+    if constexpr (std::is_copy_constructible_v<T>)
+    {
+      this->ensure_resident();
+      return make_data<T>(this->value);
+    }
+    else
+      return nullptr;
+  }
+
+  /**
+   * @brief Copies the value of another data object of the same type.
+   * @param data The data to copy from.
+   * @return True if the value has been copied.
+   */
+  bool copy_from(const BaseData &data) override
+  {
+    if constexpr (std::is_copy_assignable_v<T>)
+    {
+      if (!this->is_same_type(data)) return false;
+
+      this->value = *static_cast<const T *>(data.get_value_ptr());
+      return true;
+    }
+    else
+      return false;
+  }
+
+  /**
+   * @brief Retrieves the memory footprint of the data, see `DataSizer`.
+   * @return Size in bytes.
+   */
+  size_t get_byte_size() const override
+  {
+    return DataSizer<T>::size(this->value);
+  }
+
+  /**
+   * @brief Writes the value to a binary stream, see `DataSerializer`.
+   * @param os Output stream.
+   * @return True if the value has been written.
+   */
+  bool serialize(std::ostream &os) const override
+  {
+    this->ensure_resident();
+    return DataSerializer<T>::serialize(this->value, os);
+  }
+
+  /**
+   * @brief Reads the value from a binary stream, see `DataSerializer`.
+   * @param is Input stream.
+   * @return True if the value has been read.
+   */
+  bool deserialize(std::istream &is) override
+  {
+    return DataSerializer<T>::deserialize(is, this->value);
+  }
 
   /**
    * @brief Retrieves a pointer to the stored value.
    * @return A void pointer to the stored value.
    */
-  const void *get_value_ptr() const override { return &this->value; }
-  void       *get_value_ptr() { return &this->value; } ///< @overload
+  const void *get_value_ptr() const override
+  {
+    this->ensure_resident();
+    return &this->value;
+  }
+
+  void *get_value_ptr() override
+  {
+    this->ensure_resident();
+    return &this->value;
+  } ///< @overload
+
+protected:
+  /**
+   * @brief Release the memory held by the value, reset to `T{}`.
+   * @return True if the value has been released.
+   */
+  bool release() override
+  {
+    if constexpr (std::is_default_constructible_v<T> &&
+                  std::is_move_assignable_v<T>)
+    {
+      this->value = T{};
+      return true;
+    }
+    else
+      return false;
+  }
 
 private:
   T value{}; ///< The value of type T stored in this object.
 };
 
+/**
+ * @brief Creates a `Data<T>` object allocated from the default `BufferPool`,
+ * in cache lines of its own so that the data written by different threads
+ * never share a cache line.
+ *
+ * @tparam T The type of data to be stored.
+ * @tparam Args Types of the arguments passed to the T constructor.
+ * @param args Arguments forwarded to the constructor of T.
+ * @return The data.
+ */
+template <typename T, typename... Args>
+std::shared_ptr<Data<T>> make_data(Args &&...args)
+{
+  return std::allocate_shared<Data<T>>(PoolAllocator<Data<T>>(),
+                                       std::forward<Args>(args)...);
+}
+
 } // namespace gnode
@@ -0,0 +1,177 @@
+/* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+
+/**
+ * @file disk_cache.hpp
+ * @author Otto Link (otto.link.bv@gmail.com)
+ * @brief Defines the `DiskCache` class, a persistent cache of node outputs
+ * addressed by the node type, parameters and input data.
+ * @date 2023-08-07
+ *
+ * @copyright Copyright (c) 2023 Otto Link. Distributed under the terms of the
+ * GNU General Public License. See the file LICENSE for the full license.
+ */
+
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gnode/data.hpp"
+#include "gnode/result_cache.hpp"
+
+namespace gnode
+{
+
+/**
+ * @class DiskCache
+ * @brief Cache of node outputs stored as files in a directory, reused across
+ * application runs.
+ *
+ * Each entry is a file named after the hash of its `CacheKey`, holding the key
+ * and the serialized output data (see `DataSerializer`). Files are written to
+ * a temporary file first and then renamed, so that an interrupted write never
+ * leaves a partial entry. The least recently used entries, according to the
+ * file modification times, are removed beyond the size limit.
+ *
+ * The keys only match across runs if the parameters and input hashes are
+ * stable, which is the case of the default `DataHasher` byte-wise hashes.
+ */
+class DiskCache
+{
+public:
+  /**
+   * @brief Constructs a cache, indexing the entries already stored in the
+   * directory.
+   *
+   * @param directory Cache directory, created if needed.
+   * @param byte_limit Maximum size of the stored entries, in bytes.
+   */
+  explicit DiskCache(const std::filesystem::path &directory,
+                     size_t                       byte_limit = size_t(1) << 30);
+
+  /**
+   * @brief Remove all the entries, the statistics being kept.
+   */
+  void clear();
+
+  /**
+   * @brief Get the size limit, in bytes.
+   */
+  size_t get_byte_limit() const;
+
+  /**
+   * @brief Get the cache directory.
+   */
+  const std::filesystem::path &get_directory() const
+  {
+    return this->directory;
+  }
+
+  /**
+   * @brief Get the usage statistics.
+   */
+  CacheStats get_stats() const;
+
+  /**
+   * @brief Reset the hit, miss and eviction counters.
+   */
+  void reset_stats();
+
+  /**
+   * @brief Read the outputs stored for a key into some output data.
+   *
+   * Unreadable entries are removed.
+   *
+   * @param key Computation key.
+   * @param outputs Output data, in port order.
+   * @return true If the key has been found and the outputs restored.
+   */
+  bool restore(const CacheKey                                &key,
+               const std::vector<std::shared_ptr<BaseData>> &outputs);
+
+  /**
+   * @brief Set the size limit, entries being removed to fit in.
+   *
+   * @param new_limit Limit, in bytes.
+   */
+  void set_byte_limit(size_t new_limit);
+
+  /**
+   * @brief Store some output data.
+   *
+   * Nothing is stored if an output cannot be serialized or if the entry does
+   * not fit in the size limit.
+   *
+   * @param key Computation key.
+   * @param outputs Output data, in port order.
+   */
+  void store(const CacheKey                                &key,
+             const std::vector<std::shared_ptr<BaseData>> &outputs);
+
+private:
+  struct Entry
+  {
+    std::string name;
+    size_t      bytes = 0;
+  };
+
+  /**
+   * @brief Remove the least recently used entries beyond the size limit (lock
+   * held).
+   */
+  void evict();
+
+  /**
+   * @brief Remove an entry and its file (lock held).
+   */
+  void remove(const std::string &name);
+
+  /**
+   * @brief Cache directory.
+   */
+  std::filesystem::path directory;
+
+  /**
+   * @brief Entries, most recently used first.
+   */
+  std::list<Entry> entries;
+
+  /**
+   * @brief Entry lookup by file name.
+   */
+  std::unordered_map<std::string, std::list<Entry>::iterator> index;
+
+  /**
+   * @brief Size limit, in bytes.
+   */
+  size_t byte_limit;
+
+  /**
+   * @brief Usage statistics.
+   */
+  CacheStats stats;
+
+  /**
+   * @brief Prefix of the temporary files of this instance.
+   */
+  std::string temp_prefix;
+
+  /**
+   * @brief Count of the temporary files written by this instance.
+   */
+  uint64_t temp_count = 0;
+
+  /**
+   * @brief Guards the entries and the statistics.
+   */
+  mutable std::mutex mutex;
+};
+
+} // namespace gnode
@@ -0,0 +1,175 @@
+/* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+
+/**
+ * @file executor.hpp
+ * @author Otto Link (otto.link.bv@gmail.com)
+ * @brief Defines the executors used to run the node updates of a graph.
+ * @date 2023-08-07
+ *
+ * The graph hands over the nodes to update as a `TaskGraph`, each task being
+ * the update of one node, and the executor decides on which thread and in
+ * which order the tasks are run, a task being only started once all the tasks
+ * it depends on are done.
+ *
+ * @copyright Copyright (c) 2023 Otto Link. Distributed under the terms of the
+ * GNU General Public License. See the file LICENSE for the full license.
+ */
+
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gnode
+{
+
+/**
+ * @struct TaskGraph
+ * @brief Dependencies between the tasks of an update, in compressed sparse row
+ * form.
+ *
+ * Tasks are numbered from 0 to `size() - 1` following a topological order, so
+ * that running them in increasing order always satisfies the dependencies.
+ */
+struct TaskGraph
+{
+  /**
+   * @brief Successors of all the tasks, those of task `k` being stored between
+   * `successor_offsets[k]` and `successor_offsets[k + 1]`.
+   */
+  std::vector<uint32_t> successors;
+
+  /**
+   * @brief Offsets of the successors of each task (`size() + 1` values).
+   */
+  std::vector<uint32_t> successor_offsets;
+
+  /**
+   * @brief Number of predecessors of each task.
+   */
+  std::vector<uint32_t> in_degree;
+
+  /**
+   * @brief Scheduling priority of each task, ready tasks with the highest
+   * priority being started first (tasks are started by increasing index if
+   * empty).
+   */
+  std::vector<double> priority;
+
+  /**
+   * @brief Returns the number of tasks.
+   */
+  size_t size() const { return this->in_degree.size(); }
+};
+
+/**
+ * @class Executor
+ * @brief Interface of the task runners used by `Graph` to update its nodes.
+ */
+class Executor
+{
+public:
+  virtual ~Executor() = default;
+
+  /**
+   * @brief Returns the maximum number of tasks run concurrently.
+   */
+  virtual size_t get_concurrency() const { return 1; }
+
+  /**
+   * @brief Run all the tasks, returning once they are all done.
+   *
+   * If a task throws, no further task is started and the exception is
+   * rethrown once the tasks already running are done. Tasks must not run
+   * the executor themselves.
+   *
+   * @param tasks Task dependencies.
+   * @param task Function running a task given its index.
+   */
+  virtual void run(const TaskGraph                     &tasks,
+                   const std::function<void(uint32_t)> &task) = 0;
+};
+
+/**
+ * @class SerialExecutor
+ * @brief Runs the tasks one after the other on the calling thread, in
+ * topological order.
+ */
+class SerialExecutor : public Executor
+{
+public:
+  void run(const TaskGraph                     &tasks,
+           const std::function<void(uint32_t)> &task) override;
+};
+
+/**
+ * @class ThreadPoolExecutor
+ * @brief Runs the tasks on a pool of worker threads.
+ *
+ * Each task holds an atomic counter of its unfinished predecessors, and is
+ * queued for the workers as soon as this counter drops to zero, so that
+ * independent branches of the graph are updated concurrently. Queued tasks
+ * are started by decreasing priority.
+ */
+class ThreadPoolExecutor : public Executor
+{
+public:
+  /**
+   * @brief Constructor, starts the worker threads.
+   *
+   * @param thread_count Number of worker threads (hardware concurrency if 0).
+   */
+  explicit ThreadPoolExecutor(size_t thread_count = 0);
+
+  /**
+   * @brief Destructor, stops and joins the worker threads.
+   */
+  ~ThreadPoolExecutor() override;
+
+  ThreadPoolExecutor(const ThreadPoolExecutor &) = delete;
+  ThreadPoolExecutor &operator=(const ThreadPoolExecutor &) = delete;
+
+  size_t get_concurrency() const override { return this->workers.size(); }
+
+  /**
+   * @brief Returns the number of worker threads.
+   */
+  size_t get_thread_count() const { return this->workers.size(); }
+
+  void run(const TaskGraph                     &tasks,
+           const std::function<void(uint32_t)> &task) override;
+
+private:
+  struct Job; // forward
+
+  /**
+   * @brief Removes the ready task with the highest priority from the queue.
+   */
+  uint32_t pop_ready();
+
+  /**
+   * @brief Adds a ready task to the queue.
+   */
+  void push_ready(uint32_t task);
+
+  /**
+   * @brief Worker thread loop.
+   */
+  void work();
+
+  std::vector<std::thread> workers;         ///< Worker threads.
+  std::mutex               mutex;           ///< Protects the queue and the job.
+  std::condition_variable  cv_ready;        ///< Signals queued tasks or stop.
+  std::condition_variable  cv_done;         ///< Signals the end of a job.
+  std::vector<uint32_t>    queue;           ///< Ready tasks (binary heap).
+  Job                     *p_job = nullptr; ///< Job being run.
+  bool                     stop = false;    ///< Requests the workers to exit.
+  std::mutex               run_mutex;       ///< Serializes the `run` calls.
+};
+
+} // namespace gnode
@@ -14,20 +14,68 @@
  */
 
 #pragma once
+#include <atomic>
+#include <chrono>
+#include <filesystem>
 #include <functional>
+#include <future>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <type_traits>
 #include <unordered_set>
 
+#include "gnode/cancellation.hpp"
+#include "gnode/disk_cache.hpp"
+#include "gnode/executor.hpp"
+#include "gnode/handle.hpp"
 #include "gnode/link.hpp"
 #include "gnode/node.hpp"
+#include "gnode/parameter_table.hpp"
 #include "gnode/point.hpp"
+#include "gnode/result_cache.hpp"
 
 typedef unsigned int uint;
 
 namespace gnode
 {
 
+/**
+ * @brief Eviction of the node outputs beyond the memory budget, see
+ * `Graph::set_memory_budget`.
+ */
+enum class EvictionMode
+{
+  DROP, ///< Outputs released, recomputed when accessed again.
+  SPILL ///< Outputs written to a temporary file, read back when accessed.
+};
+
+/**
+ * @struct UpdateProgress
+ * @brief Progress of the running update, estimated with the node cost
+ * estimates.
+ */
+struct UpdateProgress
+{
+  size_t nodes_done = 0;       ///< Number of nodes updated.
+  size_t nodes_total = 0;      ///< Number of nodes to update.
+  float  fraction = 1.f;       ///< Estimated fraction of the work done.
+  double time_remaining = 0.0; ///< Estimated remaining duration (s).
+};
+
+/**
+ * @struct ExecutionPlan
+ * @brief Update of a whole graph compiled by `Graph::compile`, valid until the
+ * next structural change of the graph.
+ */
+struct ExecutionPlan
+{
+  std::vector<Node *>   nodes;                ///< Nodes, in topological order.
+  std::vector<uint32_t> slots;                ///< Slot of each node.
+  TaskGraph             tasks;                ///< Dependencies between nodes.
+  uint64_t              topology_version = 0; ///< Topology compiled.
+};
+
 /**
  * @brief The Graph class provides methods for manipulating nodes and
  * connections in a directed graph structure.
@@ -48,9 +96,9 @@ public:
   Graph(const std::string &id) : id(id) {}
 
   /**
-   * @brief Destroy the Graph object.
+   * @brief Destroy the Graph object, after the end of any asynchronous update.
    */
-  virtual ~Graph() = default;
+  virtual ~Graph();
 
   /**
    * @brief Add a new node to the graph.
@@ -75,11 +123,97 @@ public:
     return this->add_node(std::make_shared<U>(args...));
   }
 
+  /**
+   * @brief Cancel the asynchronous update in flight, if any.
+   *
+   * The update stops at the next node boundary (or earlier if the node
+   * computation polls `Node::is_cancel_requested`), its nodes already updated
+   * being reused by the next update. The call does not wait for the update to
+   * stop, see `wait_update`.
+   */
+  void cancel_update();
+
   /**
    * @brief Clear the graph, remove all the nodes and the links.
    */
   void clear();
 
+  /**
+   * @brief Compile the update of the whole graph into an execution plan, see
+   * `run`.
+   *
+   * The plan holds the nodes in topological order and the dependencies
+   * between them. It is kept by the graph until the next structural change
+   * (see `get_topology_version`).
+   *
+   * @return const ExecutionPlan& The plan.
+   */
+  const ExecutionPlan &compile();
+
+  /**
+   * @brief Evict the least recently used intermediate outputs until the memory
+   * used by the node outputs fits in the memory budget.
+   *
+   * Called after each node update for serial updates and at the end of each
+   * update otherwise, this method must not be called while an update is
+   * running. Only clean nodes with links downstream are evicted, pinned
+   * outputs (see `Node::set_output_pinned`) being kept.
+   */
+  void enforce_memory_budget();
+
+  /**
+   * @brief Update only what is needed to bring a set of nodes up to date.
+   *
+   * Only the nodes upstream of the requested nodes (included) are computed,
+   * those being dirty or depending on a dirty node. The nodes downstream of
+   * the computed nodes, outside of the requested upstream cones, are flagged
+   * dirty and left to a later update or evaluation.
+   *
+   * @param node_ids IDs of the nodes to bring up to date.
+   */
+  void evaluate(const std::vector<std::string> &node_ids);
+
+  /**
+   * @brief Update only what is needed to bring a port up to date.
+   *
+   * For an output port, the node is evaluated, for an input port, the node
+   * feeding the port is evaluated (the node itself is not computed).
+   *
+   * @param node_id ID of the node.
+   * @param port_label Label of the port.
+   * @see evaluate
+   */
+  void evaluate(const std::string &node_id, const std::string &port_label);
+
+  /**
+   * @brief Evaluate a set of nodes for each variant of a parameter table.
+   *
+   * The nodes to compute, those of the upstream cones of the requested nodes
+   * depending on an overridden port, are run once for all the variants
+   * through the executor (see `Node::update_variants`), the outputs of each
+   * node being stored for all the variants side by side in a `VariantBatch`.
+   * Nodes implementing `Node::compute_variants` get all the variants at once,
+   * the others are computed once per variant. The overridden nodes themselves
+   * are not computed.
+   *
+   * If an output of these nodes cannot be copied, the variants are instead
+   * evaluated serially, the overridden values being copied to their ports
+   * before each update of the nodes.
+   *
+   * Afterwards, the outputs of the computed nodes may hold the values of a
+   * variant: these nodes are left dirty, to be computed again by the next
+   * update. The update callback is only called by the serial evaluation.
+   *
+   * @param table Overridden output values of each variant.
+   * @param node_ids IDs of the nodes whose outputs are kept.
+   * @return BatchResult Outputs of the requested nodes for each variant
+   * (nullptr for the values that cannot be copied).
+   * @throw std::runtime_error If a node or a port is not found, or on type
+   * mismatch.
+   */
+  BatchResult evaluate_batch(const ParameterTable           &table,
+                             const std::vector<std::string> &node_ids);
+
   /**
    * @brief Compute the layout of the graph using the Sugiyama algorithm.
    *
@@ -103,7 +237,14 @@ public:
    * @param to ID of the destination node.
    * @param port_to Index of the destination node's input port.
    * @return true If the connection was successful.
-   * @return false If the connection failed.
+   * @return false If the connection failed (the link already exists or would
+   * create a cycle).
+   * @throw std::invalid_argument If the data types of the ports differ (type
+   * identifiers compared in O(1)).
+   *
+   * The topological ranks are updated incrementally: only the nodes ranked
+   * between the destination and the source nodes are visited, and the link is
+   * rejected if the destination can reach the source.
    */
   bool new_link(const std::string &from,
                 int                port_from,
@@ -219,9 +360,61 @@ public:
   /**
    * @brief Get the link storage.
    *
+   * Links are listed in their creation order.
+   *
    * @return Links.
    * */
-  const std::vector<Link> &get_links() const { return this->links; }
+  const std::vector<Link> &get_links() const;
+
+  /**
+   * @brief Get the link feeding an input port.
+   *
+   * @param node_id Identifier of the destination node.
+   * @param port_index Index of the input port.
+   * @return const Link* Link connected to the port, or nullptr if the port is
+   * not connected. If several links end on the port, the most recent one is
+   * returned.
+   */
+  const Link *get_input_link(const std::string &node_id, int port_index) const;
+
+  /**
+   * @brief Get the links leaving a node.
+   *
+   * @param node_id Identifier of the source node.
+   * @return Links starting from the node (empty if the node is unknown).
+   */
+  std::vector<Link> get_links_downstream(const std::string &node_id) const;
+
+  /**
+   * @brief Get the links entering a node.
+   *
+   * @param node_id Identifier of the destination node.
+   * @return Links ending on the node (empty if the node is unknown).
+   */
+  std::vector<Link> get_links_upstream(const std::string &node_id) const;
+
+  /**
+   * @brief Get the links leaving a node, without any copy.
+   *
+   * The view is backed by the adjacency index maintained by the link and node
+   * edition methods, it is invalidated by any subsequent structural change of
+   * the graph.
+   *
+   * @param handle Handle of the source node.
+   * @return Edges starting from the node, `Edge::node` being the destination
+   * (empty if the handle is stale).
+   */
+  const std::vector<Edge> &get_edges_downstream(NodeHandle handle) const;
+
+  /**
+   * @brief Get the links entering a node, without any copy.
+   *
+   * @param handle Handle of the destination node.
+   * @return Edges ending on the node, `Edge::node` being the source (empty if
+   * the handle is stale).
+   * @see get_edges_downstream
+   */
+  const std::vector<Edge> &get_edges_upstream(NodeHandle handle) const;
 
   /**
    * @brief Returns the link views connected to a node.
@@ -237,10 +430,53 @@ public:
    */
   std::vector<LinkView> get_link_views(const std::string &node_id) const;
 
+  /**
+   * @brief Get the handle of a node by its ID.
+   *
+   * @param node_id ID of the node.
+   * @return NodeHandle Handle of the node (invalid if the node ID is not
+   * found).
+   */
+  NodeHandle get_node_handle(const std::string &node_id) const;
+
+  /**
+   * @brief Get the ID of a node by its handle.
+   *
+   * @param handle Handle of the node.
+   * @return const std::string& ID of the node (empty if the handle is stale).
+   */
+  const std::string &get_node_id(NodeHandle handle) const;
+
+  /**
+   * @brief Get a pointer to a node by its handle.
+   *
+   * @tparam T Node type, default is Node (no cast performed).
+   * @param handle Handle of the node.
+   * @return T* Pointer to the node (returns `nullptr` if the handle is stale).
+   * @throws std::runtime_error If casting the node to the specified type fails.
+   */
+  template <typename T = Node> T *get_node_ref(NodeHandle handle) const
+  {
+    if (!this->is_handle_valid(handle)) return nullptr;
+
+    Node *p_node = this->slots[handle.index].p_node;
+
+    if constexpr (std::is_same_v<T, Node>)
+      return p_node;
+    else
+    {
+      T *ptr = dynamic_cast<T *>(p_node);
+      if (!ptr)
+        throw std::runtime_error("Failed to cast node with ID: " +
+                                 p_node->get_id() + " to the specified type.");
+      return ptr;
+    }
+  }
+
   /**
    * @brief Get a pointer to a node by its ID.
    *
-   * @tparam T Node type, default is Node.
+   * @tparam T Node type, default is Node (no cast performed).
    * @param node_id ID of the node.
    * @return T* Pointer to the node (returns `nullptr` if the node ID is not
    * found).
@@ -252,12 +488,16 @@ public:
     auto it = nodes.find(node_id);
     if (it == nodes.end()) return nullptr;
 
-    T *ptr = dynamic_cast<T *>(it->second.get());
-    if (!ptr)
-      throw std::runtime_error("Failed to cast node with ID: " + node_id +
-                               " to the specified type.");
-
-    return ptr;
+    if constexpr (std::is_same_v<T, Node>)
+      return it->second.get();
+    else
+    {
+      T *ptr = dynamic_cast<T *>(it->second.get());
+      if (!ptr)
+        throw std::runtime_error("Failed to cast node with ID: " + node_id +
+                                 " to the specified type.");
+      return ptr;
+    }
   }
 
   /**
@@ -270,6 +510,61 @@ public:
     return this->nodes;
   }
 
+  /**
+   * @brief Get the executor running the node updates.
+   *
+   * @return Executor* Executor (a serial executor by default).
+   */
+  Executor *get_executor() const { return this->executor.get(); }
+
+  /**
+   * @brief Get the persistent cache of node results.
+   *
+   * @return DiskCache* Cache, nullptr if none is set.
+   */
+  DiskCache *get_disk_cache() const { return this->disk_cache.get(); }
+
+  /**
+   * @brief Get the cache of node results.
+   *
+   * @return ResultCache* Cache, nullptr if none is set.
+   */
+  ResultCache *get_result_cache() const { return this->result_cache.get(); }
+
+  /**
+   * @brief Get the estimated duration of a node update.
+   *
+   * The estimate is a moving average of the measured update durations of the
+   * node, or the cost seed of the node label if the node has never been
+   * updated.
+   *
+   * @param node_id ID of the node.
+   * @return double Estimated duration (s).
+   */
+  double get_cost_estimate(const std::string &node_id) const;
+
+  /**
+   * @brief Get the tile size of the tiled updates, see `set_tile_size`.
+   */
+  int get_tile_size() const { return this->tile_size; }
+
+  /**
+   * @brief Get the version of the graph topology, incremented by each
+   * structural change (nodes or links added or removed).
+   */
+  uint64_t get_topology_version() const { return this->topology_version; }
+
+  /**
+   * @brief Get the topological order of the whole graph.
+   *
+   * Node ranks are maintained incrementally by `new_link` (Pearce-Kelly
+   * dynamic topological ordering), the ordered list itself is cached and only
+   * rebuilt from the ranks after a structural change of the graph.
+   *
+   * @return Node IDs sorted in topological order.
+   */
+  const std::vector<std::string> &get_topological_order() const;
+
   /** Get node list for update priority */
   std::vector<std::string> get_nodes_to_update(
       const std::vector<std::string> &node_ids);
@@ -277,26 +572,88 @@ public:
   std::vector<std::string> get_nodes_to_update(const std::string &node_id);
 
   /**
-   * @brief Checks whether the graph contains a cycle.
+   * @brief Get the memory budget of the node outputs, see
+   * `set_memory_budget`.
    *
-   * This function performs a topological sort on all nodes and compares the
-   * result size with the number of nodes in the graph.
+   * @return size_t Budget in bytes, 0 if unlimited.
+   */
+  size_t get_memory_budget() const { return this->memory_budget; }
+
+  /**
+   * @brief Get the memory used by the node outputs in memory (see
+   * `DataSizer`).
    *
-   * If the sizes differ, it means that at least one cycle exists in the
-   * dependency graph (i.e., some nodes cannot be topologically ordered).
+   * @return size_t Size in bytes.
+   */
+  size_t get_memory_usage() const;
+
+  /**
+   * @brief Checks whether the batch mode is active, see `set_batch_mode`.
+   */
+  bool is_batch_mode() const { return this->batch_mode; }
+
+  /**
+   * @brief Checks whether the execution plan is up to date with the graph
+   * topology, see `compile`.
+   */
+  bool is_compiled() const
+  {
+    return this->plan &&
+           this->plan->topology_version == this->topology_version;
+  }
+
+  /**
+   * @brief Checks whether the node updates are forced to be run one at a
+   * time.
+   */
+  bool is_deterministic() const { return this->deterministic; }
+
+  /**
+   * @brief Checks whether the early cutoff is active, see `set_early_cutoff`.
+   */
+  bool is_early_cutoff() const { return this->early_cutoff; }
+
+  /**
+   * @brief Checks whether the graph is in reactive mode, see `set_reactive`.
+   */
+  bool is_reactive() const { return this->reactive; }
+
+  /**
+   * @brief Checks whether the graph contains a cycle.
    *
-   * @warning This check is purely informational.
-   * It is NOT used as a strict execution guard in the current update pipeline,
-   * since the graph evaluation system executes nodes in a single-pass
-   * topologically ordered schedule and does not rely on reactive or recursive
-   * propagation. Therefore, cycles will not cause infinite execution loops,
-   * but they may still indicate an invalid or non-deterministic graph
-   * structure.
+   * This function compares the size of the cached topological order (see
+   * `get_topological_order`) with the number of nodes in the graph.
+   *
+   * @note Since `new_link` rejects any link that would create a cycle, a graph
+   * edited through the `Graph` API is always acyclic and this check is only
+   * kept as a consistency guard.
    *
    * @return true if a cycle is detected, false otherwise.
    */
   bool has_cycle() const;
 
+  /**
+   * @brief Get the progress of the running update (or of the last one).
+   *
+   * Can be called from any thread while the graph is being updated.
+   *
+   * @return UpdateProgress Progress estimate.
+   */
+  UpdateProgress get_update_progress() const;
+
+  /**
+   * @brief Check whether a handle refers to a node of the graph.
+   *
+   * @param handle Node handle.
+   * @return true If the handle is valid and not stale.
+   */
+  bool is_handle_valid(NodeHandle handle) const
+  {
+    return handle.index < this->slots.size() &&
+           this->slots[handle.index].generation == handle.generation &&
+           this->slots[handle.index].p_node;
+  }
+
   /**
    * @brief Check if a node ID is available in the graph.
    *
@@ -306,22 +663,85 @@ public:
    */
   bool is_node_id_available(const std::string &node_id);
 
+  /**
+   * @brief Check whether an output port of a node is linked to at least one
+   * input port.
+   *
+   * @param node_id Identifier of the node.
+   * @param port_index Index of the output port.
+   * @return true If a link starts from this port.
+   */
+  bool is_output_connected(const std::string &node_id, int port_index) const;
+
+  bool is_output_connected(NodeHandle handle,
+                           int        port_index) const; ///< @overload
+
   /**
    * @brief Checks whether a target node is reachable from a start node.
    *
-   * This function recursively traverses downstream connections to determine
-   * whether a path exists between two nodes. It can also be used to detect
-   * graph cycles (using start = node_to and target = node_from, i.e.
-   * "backwards").
+   * This function traverses downstream connections to determine whether a
+   * path exists between two nodes, pruning the nodes ranked after the target
+   * in the topological order. It can also be used to detect graph cycles
+   * (using start = node_to and target = node_from, i.e. "backwards").
    *
    * @param start Identifier of the starting node.
    * @param target Identifier of the target node.
-   * @param visited Set of already visited node identifiers.
+   * @param visited Identifiers of nodes not to be traversed (the traversal
+   * itself keeps track of the visited nodes with epoch marks).
    * @return `true` if the target node is reachable, otherwise `false`.
    */
-  bool is_reachable(const std::string              &start,
-                    const std::string              &target,
-                    std::unordered_set<std::string> visited = {}) const;
+  bool is_reachable(const std::string                     &start,
+                    const std::string                     &target,
+                    const std::unordered_set<std::string> &visited = {}) const;
+
+  /**
+   * @brief Checks whether a node input is the only consumer of the output it
+   * is linked to, which can then be taken over by the node (see
+   * `Node::take_input`).
+   *
+   * @param handle Handle of the consumer node.
+   * @param port_index Index of the input port.
+   * @return true If the input is linked to an output linked to no other input,
+   * neither pinned nor evicted.
+   */
+  bool is_sole_consumer(NodeHandle handle, int port_index) const;
+
+  /**
+   * @brief Update right away the nodes enqueued for a coalesced update.
+   *
+   * @return true If there were enqueued nodes.
+   * @see poll_updates
+   */
+  bool flush_updates();
+
+  /**
+   * @brief Run the coalesced update of the enqueued nodes, if due.
+   *
+   * The nodes enqueued by `request_update` (or by `Node::set_value` in
+   * reactive mode) are merged into a single update, run once no request has
+   * been made for the debounce delay or once the oldest pending request is
+   * older than the latency budget. Meant to be called once per frame by the
+   * application.
+   *
+   * @return true If an update has been run.
+   */
+  bool poll_updates();
+
+  /**
+   * @brief Flag nodes and all the nodes downstream as dirty, without updating
+   * them.
+   *
+   * @param node_ids IDs of the nodes.
+   * @see evaluate
+   */
+  void mark_dirty(const std::vector<std::string> &node_ids);
+
+  /**
+   * @brief Flag a node and all the nodes downstream as dirty.
+   *
+   * @param node_id ID of the node.
+   */
+  void mark_dirty(const std::string &node_id);
 
   /**
    * @brief Method called after the graph update process is completed.
@@ -336,6 +756,26 @@ public:
    */
   void print();
 
+  /**
+   * @brief Release the output linked to a node input, once its value has been
+   * taken over by the node (see `Node::take_input`).
+   *
+   * The output is flagged as dropped and recomputed if accessed again, as with
+   * the memory budget (see `set_memory_budget`).
+   *
+   * @param handle Handle of the consumer node.
+   * @param port_index Index of the input port.
+   */
+  void release_input(NodeHandle handle, int port_index);
+
+  /**
+   * @brief Flag a node as dirty and enqueue it for the next coalesced update,
+   * see `poll_updates`.
+   *
+   * @param node_id ID of the node.
+   */
+  void request_update(const std::string &node_id);
+
   /**
    * @brief Remove a node from the graph by its ID.
    *
@@ -343,6 +783,116 @@ public:
    */
   virtual void remove_node(const std::string &id);
 
+  /**
+   * @brief Update the whole graph with the execution plan, compiled again
+   * first if the topology has changed (see `compile`).
+   *
+   * All the nodes are computed, with the least overhead per node: the update
+   * callback, the progress, the early cutoff, the batch mode and the tiled
+   * updates are skipped, and serial executors run a plain loop over the plan.
+   * The result and disk caches are bypassed as well, the nodes being computed
+   * without hashing their inputs or looking up and storing their outputs.
+   *
+   * An asynchronous update in flight is cancelled and waited for first (see
+   * `update_async`).
+   */
+  void run();
+
+  /**
+   * @brief Set the batch mode, for headless runs where only the outputs of
+   * the last nodes of the updates are needed.
+   *
+   * During an update, each output counts the updates of its consumers left,
+   * and is released once all of them are done, the peak memory following the
+   * live frontier of the update rather than the sum of all the outputs. The
+   * outputs of the nodes without consumer in the update are kept, and pinned
+   * outputs are never released. A released output is recomputed if accessed
+   * again (see `set_memory_budget`).
+   *
+   * @param new_state Activation flag.
+   */
+  void set_batch_mode(bool new_state) { this->batch_mode = new_state; }
+
+  /**
+   * @brief Set the estimated update duration of the nodes with a given label,
+   * used until the duration of a node is measured.
+   *
+   * @param node_label Node label.
+   * @param cost Estimated duration (s).
+   */
+  void set_cost_seed(const std::string &node_label, double cost)
+  {
+    this->cost_seeds[node_label] = cost;
+  }
+
+  /**
+   * @brief Force the node updates to be run one at a time, in topological
+   * order, whatever the executor (for reproducibility purposes).
+   *
+   * @param new_state Activation flag.
+   */
+  void set_deterministic(bool new_state) { this->deterministic = new_state; }
+
+  /**
+   * @brief Set the persistent cache of node results, looked up after the
+   * result cache (see `set_result_cache`) and written along with it.
+   *
+   * Nodes providing a parameters hash and whose outputs can be serialized
+   * (see `DataSerializer`) are then restored from the results of the
+   * previous runs.
+   *
+   * @param new_cache Cache, nullptr to disable it (default).
+   */
+  void set_disk_cache(std::shared_ptr<DiskCache> new_cache)
+  {
+    this->disk_cache = std::move(new_cache);
+  }
+
+  /**
+   * @brief Stop the update propagation at the nodes whose outputs are
+   * unchanged by their computation.
+   *
+   * The outputs of each computed node are hashed (see `DataHasher`). A node
+   * only flagged dirty because of the nodes upstream is not computed when
+   * none of them produced new outputs, and is considered up to date. Nodes
+   * with outputs that cannot be hashed are always considered as changed.
+   *
+   * @param new_state Activation flag.
+   */
+  void set_early_cutoff(bool new_state) { this->early_cutoff = new_state; }
+
+  /**
+   * @brief Set the executor running the node updates.
+   *
+   * Nodes are updated concurrently by parallel executors, as soon as the
+   * nodes upstream are up to date. The update callback calls are serialized
+   * and `post_update` is still called once all the nodes are updated.
+   *
+   * @param new_executor Executor (a serial executor is used if nullptr).
+   */
+  void set_executor(std::shared_ptr<Executor> new_executor);
+
+  /**
+   * @brief Set the reactive mode, in which `Node::set_value` enqueues the
+   * node for the next coalesced update (see `poll_updates`).
+   *
+   * @param new_state Activation flag.
+   */
+  void set_reactive(bool new_state) { this->reactive = new_state; }
+
+  /**
+   * @brief Set the cache of node results, used by the nodes providing a
+   * parameters hash (see `Node::get_parameters_hash`).
+   *
+   * A cache can be shared between several graphs.
+   *
+   * @param new_cache Cache, nullptr to disable caching (default).
+   */
+  void set_result_cache(std::shared_ptr<ResultCache> new_cache)
+  {
+    this->result_cache = std::move(new_cache);
+  }
+
   /**
    * @brief Set the graph ID.
    *
@@ -357,6 +907,46 @@ public:
    * */
   void set_id_count(uint new_id_count) { this->id_count = new_id_count; }
 
+  /**
+   * @brief Set a memory budget for the node outputs.
+   *
+   * Beyond the budget, the least recently used intermediate outputs are
+   * either released or spilled to a temporary file (outputs that cannot be
+   * serialized being released), and are brought back transparently when
+   * accessed again through `get_value_ref` or by a downstream update:
+   * released outputs are recomputed, spilled ones read back.
+   *
+   * @param new_budget Budget in bytes, 0 for no budget (default).
+   * @param new_mode Eviction mode.
+   */
+  void set_memory_budget(size_t       new_budget,
+                         EvictionMode new_mode = EvictionMode::DROP)
+  {
+    this->memory_budget = new_budget;
+    this->eviction_mode = new_mode;
+  }
+
+  /**
+   * @brief Set the tile size of the tiled updates, 0 to disable them.
+   *
+   * Connected dirty nodes declaring the same raster size (see
+   * `Node::get_tiling`) are then computed tile by tile, each tile going
+   * through all the nodes in turn (see `Node::compute_tile`), so that the
+   * data of a tile stays in cache. Each
+   * node computes the tile grown by the halos of the nodes downstream, and
+   * the tiles are spread over the executor threads, in four interleaved
+   * phases if the halos overlap the neighbouring tiles (tiles being computed
+   * one after the other if the halos exceed half a tile).
+   *
+   * Nodes computed by tiles skip the result caches and the early cutoff.
+   *
+   * @param new_tile_size Tile size, in cells.
+   */
+  void set_tile_size(int new_tile_size)
+  {
+    this->tile_size = std::max(0, new_tile_size);
+  }
+
   void set_update_callback(std::function<void(const std::string &,
                                               const std::vector<std::string> &,
                                               bool)> new_callback)
@@ -364,6 +954,28 @@ public:
     this->update_callback = new_callback;
   }
 
+  /**
+   * @brief Set the quiet delay after the last update request before a
+   * coalesced update is run, see `poll_updates`.
+   *
+   * @param new_debounce Delay (s).
+   */
+  void set_update_debounce(double new_debounce)
+  {
+    this->update_debounce = new_debounce;
+  }
+
+  /**
+   * @brief Set the maximum delay between an update request and the coalesced
+   * update including it, see `poll_updates`.
+   *
+   * @param new_budget Delay (s).
+   */
+  void set_update_latency_budget(double new_budget)
+  {
+    this->update_latency_budget = new_budget;
+  }
+
   /** Kahn's algorithm for node sorting for update priority */
   std::vector<std::string> topological_sort(
       const std::vector<std::string> &dirty_node_ids) const;
@@ -390,6 +1002,36 @@ public:
    */
   virtual void update(const std::vector<std::string> &node_ids);
 
+  /**
+   * @brief Update nodes on a background thread.
+   *
+   * An update already in flight is preempted at the next node boundary. The
+   * new update covers the nodes downstream of both the new nodes and the
+   * nodes of the preempted update, the nodes up to date being reused. The
+   * update callback and `post_update` are called from the background thread,
+   * and the graph must not be edited while the update is running.
+   *
+   * @param node_ids IDs of the nodes to update.
+   * @return std::shared_future<bool> Resolves to true once the update is
+   * done, or to false if it has been cancelled or preempted.
+   */
+  std::shared_future<bool> update_async(
+      const std::vector<std::string> &node_ids);
+
+  /**
+   * @brief Update a node on a background thread.
+   *
+   * @param node_id ID of the node to update.
+   * @return std::shared_future<bool> Update completion.
+   * @see update_async
+   */
+  std::shared_future<bool> update_async(const std::string &node_id);
+
+  /**
+   * @brief Wait for the end of the asynchronous update in flight, if any.
+   */
+  void wait_update();
+
 protected:
   /**
    * @brief A map of node IDs to shared pointers of Node objects.
@@ -397,11 +1039,432 @@ protected:
   std::map<std::string, std::shared_ptr<Node>> nodes;
 
   /**
-   * @brief A list of links between nodes in the graph.
+   * @brief A list of links between nodes in the graph, in their creation order
+   * (string lookup layer of the link table, maintained by the link and node
+   * edition methods).
    */
-  std::vector<Link> links;
+  mutable std::vector<Link> links;
 
 private:
+  /**
+   * @brief Node storage slot, addressed by the index of a `NodeHandle`.
+   */
+  struct NodeSlot
+  {
+    Node             *p_node = nullptr; ///< Node, nullptr for a free slot.
+    std::string       id;               ///< Node ID.
+    uint32_t          generation = 0;   ///< Bumped each time the slot is freed.
+    size_t            rank = 0;         ///< Rank in the topological order.
+    mutable uint32_t  order_pos = 0;    ///< Position in the cached order.
+    mutable uint32_t  mark = 0;         ///< Epoch of the last traversal visit.
+    mutable uint32_t  in_degree = 0;    ///< Scratch in-degree for sorting.
+    mutable uint32_t  task = 0;         ///< Scratch task index for updates.
+    double            cost = -1.0;      ///< Update duration estimate (s).
+    uint64_t          output_hash = 0;  ///< Outputs hash after last compute.
+    bool              has_hash = false; ///< Whether output_hash is set.
+    bool              is_forced = true; ///< Not to be cut off when dirty.
+    uint64_t          last_use = 0;     ///< Use tick, for evictions.
+    std::vector<Edge> upstream;         ///< Links ending on the node.
+    std::vector<Edge> downstream;       ///< Links starting from the node.
+  };
+
+  /**
+   * @brief Node slots, the index of a slot being the index of the handle of
+   * the node it holds.
+   */
+  std::vector<NodeSlot> slots;
+
+  /**
+   * @brief Indices of the released slots, reused by `add_node`.
+   */
+  std::vector<uint32_t> free_slots;
+
+  /**
+   * @brief Links stored as integer handles and port indices.
+   */
+  LinkTable link_table;
+
+  /**
+   * @brief Row in the link table of each link of `links` (increasing). The
+   * links of the removed rows are kept until the links are read again, see
+   * `drop_removed_links`.
+   */
+  mutable std::vector<size_t> link_rows;
+
+  /**
+   * @brief Executor running the node updates.
+   */
+  std::shared_ptr<Executor> executor = std::make_shared<SerialExecutor>();
+
+  /**
+   * @brief Cache of node results, if any.
+   */
+  std::shared_ptr<ResultCache> result_cache;
+
+  /**
+   * @brief Persistent cache of node results, if any.
+   */
+  std::shared_ptr<DiskCache> disk_cache;
+
+  /**
+   * @brief Flag forcing the node updates to be run serially.
+   */
+  bool deterministic = false;
+
+  /**
+   * @brief Batch mode flag, see `set_batch_mode`.
+   */
+  bool batch_mode = false;
+
+  /**
+   * @brief Whether the variants of a batch evaluation are being computed, the
+   * inputs of the nodes being bound to the data of a variant.
+   */
+  std::atomic<bool> is_evaluating_variants = false;
+
+  /**
+   * @brief Tile size of the tiled updates (0 if disabled).
+   */
+  int tile_size = 0;
+
+  /**
+   * @brief Execution plan, see `compile`.
+   */
+  std::unique_ptr<ExecutionPlan> plan;
+
+  /**
+   * @brief Topology version, see `get_topology_version`.
+   */
+  uint64_t topology_version = 0;
+
+  /**
+   * @brief Memory budget of the node outputs (bytes, 0 if unlimited).
+   */
+  size_t memory_budget = 0;
+
+  /**
+   * @brief Eviction mode beyond the memory budget.
+   */
+  EvictionMode eviction_mode = EvictionMode::DROP;
+
+  /**
+   * @brief Directory of the spilled outputs, created on the first spill.
+   */
+  std::filesystem::path spill_directory;
+
+  /**
+   * @brief Count of the spill files.
+   */
+  uint64_t spill_count = 0;
+
+  /**
+   * @brief Clock of the node uses, for the least recently used evictions.
+   */
+  std::atomic<uint64_t> use_clock = 0;
+
+  /**
+   * @brief Serializes the restoration of the evicted outputs.
+   */
+  std::recursive_mutex restore_mutex;
+
+  /**
+   * @brief Slots of the nodes being recomputed to restore their outputs.
+   */
+  std::vector<uint32_t> restoring_slots;
+
+  /**
+   * @brief Early cutoff flag, see `set_early_cutoff`.
+   */
+  bool early_cutoff = false;
+
+  /**
+   * @brief Reactive mode flag, see `set_reactive`.
+   */
+  bool reactive = false;
+
+  /**
+   * @brief Quiet delay before a coalesced update (s).
+   */
+  double update_debounce = 0.0;
+
+  /**
+   * @brief Maximum delay of a coalesced update (s).
+   */
+  double update_latency_budget = 0.1;
+
+  /**
+   * @brief Nodes enqueued for the next coalesced update.
+   */
+  std::vector<std::string> pending_ids;
+
+  /**
+   * @brief Time of the oldest and of the latest pending update requests.
+   */
+  std::chrono::steady_clock::time_point pending_first_request;
+  std::chrono::steady_clock::time_point pending_last_request;
+
+  /**
+   * @brief Protects the pending update requests.
+   */
+  std::mutex pending_mutex;
+
+  /**
+   * @brief Estimated update durations by node label (s).
+   */
+  std::map<std::string, double> cost_seeds;
+
+  /**
+   * @brief Cost estimate of the nodes without any seed nor measure (s).
+   */
+  static constexpr double default_cost = 1e-3;
+
+  /**
+   * @brief Weight of the last measure in the moving average of the update
+   * durations.
+   */
+  static constexpr double cost_smoothing = 0.3;
+
+  /**
+   * @brief Progress of the running update, see `get_update_progress`.
+   */
+  std::atomic<size_t> progress_nodes_done = 0;
+  std::atomic<size_t> progress_nodes_total = 0;
+  std::atomic<double> progress_cost_done = 0.0;
+  std::atomic<double> progress_cost_total = 0.0;
+  std::atomic<double> progress_parallelism = 1.0;
+
+  /**
+   * @brief Cached topological order of the whole graph, see
+   * `get_topological_order`.
+   */
+  mutable std::vector<std::string> topological_order;
+
+  /**
+   * @brief Slot indices of the cached topological order, the entries of the
+   * removed nodes being set to `NodeHandle::invalid_index` until the order is
+   * read again.
+   */
+  mutable std::vector<uint32_t> topological_slots;
+
+  /**
+   * @brief Number of removed entries in the cached topological order.
+   */
+  mutable size_t topological_removed = 0;
+
+  /**
+   * @brief Rank given to the next node added to the graph.
+   */
+  size_t next_rank = 0;
+
+  /**
+   * @brief Flag indicating whether the cached topological order is out of
+   * date with respect to the ranks.
+   */
+  mutable bool is_topology_dirty = true;
+
+  /**
+   * @brief Current traversal epoch, a slot is visited if its mark equals the
+   * epoch.
+   */
+  mutable uint32_t mark_epoch = 0;
+
+  /**
+   * @brief Start a new traversal, all the slots become unvisited.
+   *
+   * @return New epoch value.
+   */
+  uint32_t new_mark_epoch() const;
+
+  /**
+   * @brief Drop the removed rows from the link table, preserving the order of
+   * the remaining ones.
+   */
+  void compact_links();
+
+  /**
+   * @brief Drop the links whose row has been removed from `links`, in a
+   * single pass preserving the order of the remaining ones.
+   */
+  void drop_removed_links() const;
+
+  /**
+   * @brief Get the position in `links` of a link of the link table.
+   *
+   * @param row Row of the link, not removed.
+   * @return Position of the link.
+   */
+  size_t get_link_position(size_t row) const;
+
+  /**
+   * @brief Remove a link from the adjacency index and flag its row as erased
+   * in the link table.
+   *
+   * @param row Row of the link in the link table.
+   */
+  void erase_link(size_t row);
+
+  /**
+   * @brief Reconnect an input port after the removal of a link ending on it.
+   *
+   * If the port is still fed by another link, the most recent one takes over,
+   * otherwise the input data is cleared.
+   *
+   * @param to Slot index of the destination node.
+   * @param port_to Index of the destination node's input port.
+   */
+  void rebind_input(uint32_t to, int port_to);
+
+  /**
+   * @brief Get the estimated update duration of a slot, see
+   * `get_cost_estimate`.
+   */
+  double get_slot_cost(uint32_t index) const;
+
+  /**
+   * @brief Get the slots of the nodes to update, sorted in topological order.
+   *
+   * @param node_ids IDs of the nodes starting the update.
+   * @param epoch Traversal epoch marking the returned slots.
+   * @return Slot indices (empty if a node is unknown or if a node upstream
+   * is dirty).
+   */
+  std::vector<uint32_t> get_slots_to_update(
+      const std::vector<std::string> &node_ids,
+      uint32_t                       &epoch);
+
+  /**
+   * @brief Flag dirty the nodes of an update cone.
+   *
+   * The roots, and the nodes already dirty for another reason, are always
+   * computed, while the other nodes can be cut off (see `set_early_cutoff`).
+   *
+   * @param cone Slot indices of the cone, roots included.
+   * @param roots Slot indices of the roots.
+   */
+  void flag_dirty(const std::vector<uint32_t> &cone,
+                  const std::vector<uint32_t> &roots);
+
+  /**
+   * @brief Mark the nodes downstream of a set of slots, the slots included.
+   *
+   * @param roots Slot indices.
+   * @param epoch Traversal epoch used to mark the slots.
+   * @return Marked slot indices.
+   */
+  std::vector<uint32_t> mark_downstream(
+      const std::vector<uint32_t> &roots,
+      uint32_t                     epoch) const;
+
+  /**
+   * @brief Mark the nodes upstream of a set of slots, the slots included.
+   *
+   * @param roots Slot indices.
+   * @param epoch Traversal epoch used to mark the slots.
+   * @return Marked slot indices.
+   */
+  std::vector<uint32_t> mark_upstream(
+      const std::vector<uint32_t> &roots,
+      uint32_t                     epoch) const;
+
+  /**
+   * @brief Flag the evicted outputs of a node as in memory, their current
+   * value being discarded (the node is about to be computed or removed).
+   *
+   * @param p_node Node.
+   */
+  void discard_evicted_outputs(Node *p_node);
+
+  /**
+   * @brief Evict the outputs of a node.
+   *
+   * @param index Slot index.
+   * @param mode Eviction mode.
+   * @return size_t Memory released, in bytes.
+   */
+  size_t evict_outputs(uint32_t index, EvictionMode mode);
+
+  /**
+   * @brief Bring back the evicted outputs of a node (restore hook of the
+   * evicted data).
+   *
+   * @param handle Node handle.
+   */
+  void restore_outputs(NodeHandle handle);
+
+  /**
+   * @brief Asynchronous update body, see `update_async`.
+   *
+   * @param node_ids IDs of the nodes requested by the update.
+   * @param root_ids IDs of the requested nodes and of the nodes of the
+   * preempted updates.
+   * @param token Cancellation token of the update.
+   * @return true If the update has not been interrupted.
+   */
+  bool run_async_update(const std::vector<std::string>           &node_ids,
+                        const std::vector<std::string>           &root_ids,
+                        const std::shared_ptr<CancellationToken> &token);
+
+  /**
+   * @brief Kahn's algorithm restricted to a subset of slots.
+   *
+   * Only the links between slots of the subset are considered, so that the
+   * cost is linear in the size of the subset and of its links.
+   *
+   * @param subset Slot indices, all marked with `epoch` and without
+   * duplicates.
+   * @param epoch Traversal epoch identifying the subset.
+   * @return Slot indices sorted in topological order.
+   */
+  std::vector<uint32_t> topological_sort_slots(
+      const std::vector<uint32_t> &subset,
+      uint32_t                     epoch) const;
+
+  /**
+   * @brief Update the topological ranks before adding a link (Pearce-Kelly).
+   *
+   * @param from Slot index of the source node.
+   * @param to Slot index of the destination node.
+   * @return false If the link would create a cycle (ranks are left unchanged).
+   */
+  bool update_topological_rank(uint32_t from, uint32_t to);
+
+  /**
+   * @brief Update nodes with the graph executor.
+   *
+   * @param sorted_slots Slot indices of the nodes, in topological order and
+   * all marked with `epoch`.
+   * @param sorted_ids IDs of the nodes, in the same order.
+   * @param epoch Traversal epoch identifying the nodes.
+   * @param p_token Cancellation token checked before each node update
+   * (nullptr if the update cannot be cancelled).
+   * @return true If all the nodes are up to date, false if the update has
+   * been cancelled.
+   */
+  bool update_slots(const std::vector<uint32_t>    &sorted_slots,
+                    const std::vector<std::string> &sorted_ids,
+                    uint32_t                        epoch,
+                    const CancellationToken        *p_token = nullptr);
+
+  /**
+   * @brief Protects the state of the asynchronous updates.
+   */
+  std::mutex async_mutex;
+
+  /**
+   * @brief Completion of the last asynchronous update.
+   */
+  std::shared_future<bool> async_update;
+
+  /**
+   * @brief Cancellation token of the last asynchronous update.
+   */
+  std::shared_ptr<CancellationToken> async_token;
+
+  /**
+   * @brief Nodes requested by the asynchronous updates not completed yet.
+   */
+  std::vector<std::string> async_roots;
+
   /**
    * @brief Keep track of unique identifiers.
    */
@@ -0,0 +1,54 @@
+/* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+
+/**
+ * @file handle.hpp
+ * @author Otto Link (otto.link.bv@gmail.com)
+ * @brief Defines the `NodeHandle` struct used to address nodes within a graph.
+ * @date 2023-08-07
+ *
+ * @copyright Copyright (c) 2023 Otto Link. Distributed under the terms of the
+ * GNU General Public License. See the file LICENSE for the full license.
+ */
+
+#pragma once
+#include <cstdint>
+#include <limits>
+
+namespace gnode
+{
+
+/**
+ * @struct NodeHandle
+ * @brief Dense integer handle of a node within a graph.
+ *
+ * The handle is made of the index of the storage slot of the node in the graph
+ * and of a generation counter, incremented each time the slot is released. A
+ * handle referring to a removed node is therefore detected as stale, even if
+ * its slot has been reused by another node.
+ */
+struct NodeHandle
+{
+  /**
+   * @brief Index value of a handle not referring to any node.
+   */
+  static constexpr uint32_t invalid_index =
+      std::numeric_limits<uint32_t>::max();
+
+  uint32_t index = invalid_index; ///< Index of the node slot.
+  uint32_t generation = 0;        ///< Generation of the node slot.
+
+  /**
+   * @brief Check whether the handle has been assigned to a node.
+   * @return `true` if the handle refers to a node slot.
+   */
+  bool is_valid() const { return this->index != invalid_index; }
+
+  /**
+   * @brief Equality operator for `NodeHandle`.
+   */
+  bool operator==(const NodeHandle &other) const = default;
+};
+
+} // namespace gnode
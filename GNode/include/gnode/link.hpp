@@ -18,9 +18,13 @@
  */
 
 #pragma once
+#include <cstdint>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "gnode/handle.hpp"
+
 namespace gnode
 {
 
@@ -69,6 +73,152 @@ struct Link
   void print() const;
 };
 
+/**
+ * @struct Edge
+ * @brief Compact link entry of the graph adjacency index.
+ *
+ * An `Edge` is stored by each of the two nodes connected by a link, `node`
+ * being the handle of the node at the other end of the link.
+ */
+struct Edge
+{
+  NodeHandle node;      ///< Handle of the node at the other end of the link.
+  int        port_from; ///< Port number on the source node.
+  int        port_to;   ///< Port number on the destination node.
+
+  /**
+   * @brief Equality operator for `Edge`.
+   */
+  bool operator==(const Edge &other) const = default;
+};
+
+/**
+ * @class LinkTable
+ * @brief Structure-of-arrays storage of the graph links.
+ *
+ * Each row describes a link using the slot indices of the connected nodes and
+ * the port indices, the columns being stored in separate contiguous arrays.
+ *
+ * The rows are indexed by their full key and by their destination port, so
+ * that looking up, adding or removing a link is done in constant time.
+ * Removed rows are only flagged as erased (tombstones), the order of the
+ * remaining rows being preserved when the table is compacted.
+ */
+class LinkTable
+{
+public:
+  std::vector<uint32_t> from;      ///< Slot index of the source node.
+  std::vector<int>      port_from; ///< Port number on the source node.
+  std::vector<uint32_t> to;        ///< Slot index of the destination node.
+  std::vector<int>      port_to;   ///< Port number on the destination node.
+
+  /**
+   * @brief Position of the link in the downstream edges of its source node.
+   */
+  std::vector<uint32_t> pos_downstream;
+
+  /**
+   * @brief Position of the link in the upstream edges of its destination node.
+   */
+  std::vector<uint32_t> pos_upstream;
+
+  /**
+   * @brief Row value returned when no row is found.
+   */
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  /**
+   * @brief Removes all the rows.
+   */
+  void clear();
+
+  /**
+   * @brief Removes the erased rows, preserving the order of the other rows.
+   */
+  void compact();
+
+  /**
+   * @brief Flags a row as erased and removes it from the indices.
+   */
+  void erase(size_t row);
+
+  /**
+   * @brief Returns the row of a link, or `npos` if the link does not exist.
+   */
+  size_t find(uint32_t from, int port_from, uint32_t to, int port_to) const;
+
+  /**
+   * @brief Returns the row of the link feeding an input port, or `npos` if
+   * the port is not connected.
+   */
+  size_t find_input(uint32_t to, int port_to) const;
+
+  /**
+   * @brief Returns the number of rows flagged as erased.
+   */
+  size_t get_erased_count() const { return this->erased_count; }
+
+  /**
+   * @brief Makes a row the link feeding its destination port.
+   */
+  void index_input(size_t row);
+
+  /**
+   * @brief Checks whether a row has not been erased.
+   */
+  bool is_alive(size_t row) const
+  {
+    return this->from[row] != NodeHandle::invalid_index;
+  }
+
+  /**
+   * @brief Appends a new row to the table.
+   * @return Index of the new row.
+   */
+  size_t push_back(uint32_t from, int port_from, uint32_t to, int port_to);
+
+  /**
+   * @brief Returns the number of rows, erased rows included.
+   */
+  size_t size() const { return this->from.size(); }
+
+private:
+  /**
+   * @brief Link key, made of the packed source and destination port keys.
+   */
+  using Key = std::pair<uint64_t, uint64_t>;
+
+  /**
+   * @brief Hash of a link key.
+   */
+  struct KeyHash
+  {
+    size_t operator()(const std::pair<uint64_t, uint64_t> &key) const
+    {
+      uint64_t h = key.first * 0x9e3779b97f4a7c15ull;
+      h ^= key.second + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+      return static_cast<size_t>(h);
+    }
+  };
+
+  std::unordered_map<Key, size_t, KeyHash> rows;       ///< Link -> row.
+  std::unordered_map<uint64_t, size_t>     input_rows; ///< Input -> row.
+  size_t                                   erased_count = 0;
+
+  /**
+   * @brief Packs a slot index and a port index into a port key.
+   */
+  static uint64_t port_key(uint32_t node, int port)
+  {
+    return (uint64_t(node) << 32) | uint32_t(port);
+  }
+
+  /**
+   * @brief Rebuilds the indices from the columns.
+   */
+  void rebuild_indices();
+};
+
 /**
  * @struct LinkView
  * @brief Provides a resolved and enriched view of a graph link.
@@ -13,12 +13,17 @@
  */
 
 #pragma once
+#include <atomic>
 #include <memory>
 #include <stdexcept>
 #include <vector>
 
+#include "gnode/cancellation.hpp"
 #include "gnode/data.hpp"
+#include "gnode/handle.hpp"
+#include "gnode/parameter_table.hpp"
 #include "gnode/port.hpp"
+#include "gnode/tiling.hpp"
 
 namespace gnode
 {
@@ -78,6 +83,8 @@ public:
    * @param port_label The label for the port.
    * @param args Additional arguments passed to the output port constructor if
    * the port type is output.
+   * @return PortRef<T> The new port, convertible to the `InPort<T>` or
+   * `OutPort<T>` handle that nodes store to access the port in `compute`.
    *
    * This function adds a port of type `T` to the node. If the port type is
    * `PortType::IN`, it creates an `Input` port with the given `port_label`. If
@@ -86,9 +93,9 @@ public:
    * constructor.
    */
   template <typename T, typename... Args>
-  void add_port(PortType           port_type,
-                const std::string &port_label,
-                Args &&...args)
+  PortRef<T> add_port(PortType           port_type,
+                      const std::string &port_label,
+                      Args &&...args)
   {
     if (port_type == PortType::IN)
       this->ports.push_back(std::make_shared<gnode::Input<T>>(port_label));
@@ -96,6 +103,8 @@ public:
       this->ports.push_back(
           std::make_shared<gnode::Output<T>>(port_label,
                                              std::forward<Args>(args)...));
+
+    return PortRef<T>(this->ports.back().get());
   }
 
   /**
@@ -104,6 +113,47 @@ public:
    */
   virtual void compute() = 0;
 
+  /**
+   * @brief Compute the outputs over a region only, for the tiled updates of
+   * the nodes declaring a tiling (see `get_tiling` and
+   * `Graph::set_tile_size`).
+   *
+   * The inputs are only read within the region grown by the halo of the
+   * node, and the outputs only written within the region. Tiles of the same
+   * update can be computed concurrently.
+   *
+   * @param region Region to compute.
+   */
+  virtual void compute_tile(const TileRegion & /* region */) {}
+
+  /**
+   * @brief Compute the outputs of all the variants of a batch evaluation at
+   * once (see `Graph::evaluate_batch`), to be overridden by the nodes able to
+   * process the variants together, e.g. vectorized across the variants.
+   *
+   * The outputs of each variant are written to their own data in the batch,
+   * the data of the node ports being left untouched.
+   *
+   * @param batch Data of the ports for each variant.
+   * @return true If the outputs have been computed, false (default) to have
+   * `compute` called once per variant instead.
+   */
+  virtual bool compute_variants(VariantBatch & /* batch */) { return false; }
+
+  /**
+   * @brief Start a tiled update of the node (managed by the graph), see
+   * `prepare_tiles`.
+   */
+  void begin_tiles();
+
+  /**
+   * @brief Complete a tiled update of the node (managed by the graph).
+   *
+   * @param is_complete Whether all the tiles have been computed, the node
+   * being left dirty otherwise.
+   */
+  void end_tiles(bool is_complete);
+
   /**
    * @brief Retrieves a shared pointer to the data associated with the port
    * after downcasting.
@@ -131,6 +181,14 @@ public:
    */
   std::string get_data_type(int port_index) const;
 
+  /**
+   * @brief Get the identifier of the data type of a port (input or output).
+   *
+   * @param port_index The index of the port.
+   * @return TypeId The type identifier.
+   */
+  TypeId get_data_type_id(int port_index) const;
+
   /**
    * @brief Get the id of the graph.
    *
@@ -145,6 +203,14 @@ public:
    */
   std::string get_label() const { return this->label; }
 
+  /**
+   * @brief Get the handle of the node within its graph.
+   *
+   * @return NodeHandle The handle (invalid if the node does not belong to a
+   * graph).
+   */
+  NodeHandle get_handle() const { return this->handle; }
+
   /**
    * @brief Get the ID of the node.
    *
@@ -175,6 +241,40 @@ public:
    */
   std::shared_ptr<BaseData> get_output_data(int port_index) const;
 
+  /**
+   * @brief Get a hash combining the data of all the output ports.
+   *
+   * @return The hash, or `std::nullopt` if an output cannot be hashed.
+   */
+  std::optional<uint64_t> get_output_hash() const;
+
+  /**
+   * @brief Get a hash of the node parameters, to be overridden by the nodes
+   * opting in for the result cache of their graph (see `ResultCache`).
+   *
+   * Only nodes whose outputs depend on nothing but their parameters and input
+   * data should opt in, all the values affecting the computation being
+   * hashed.
+   *
+   * @return The hash, or `std::nullopt` (default) to always compute.
+   */
+  virtual std::optional<uint64_t> get_parameters_hash() const
+  {
+    return std::nullopt;
+  }
+
+  /**
+   * @brief Get the tiling of the node outputs, to be overridden by the nodes
+   * computing their outputs region by region (see `compute_tile`).
+   *
+   * @return The tiling, or `std::nullopt` (default) to always compute the
+   * outputs at once.
+   */
+  virtual std::optional<TilingScheme> get_tiling() const
+  {
+    return std::nullopt;
+  }
+
   /**
    * @brief Get the reference to the belonging graph.
    *
@@ -214,6 +314,27 @@ public:
     return this->ports;
   };
 
+  /**
+   * @brief Get the last published value of a double-buffered output, see
+   * `set_output_double_buffered`.
+   *
+   * Can be called from any thread while the graph is being updated.
+   *
+   * @tparam T The type of the value.
+   * @param port_label The label of the output port.
+   * @return Snapshot<T> The value and its version, empty if the port is not
+   * found, not of type T or if no value has been published yet.
+   */
+  template <typename T>
+  Snapshot<T> get_snapshot(const std::string &port_label) const
+  {
+    const int index = this->get_port_index(port_label);
+    if (index < 0) return {};
+
+    auto port = std::dynamic_pointer_cast<Output<T>>(this->ports[index]);
+    return port ? port->get_snapshot() : Snapshot<T>();
+  }
+
   /**
    * @brief Get a reference to the value stored in a port by its label.
    *
@@ -308,6 +429,16 @@ public:
    */
   bool is_port_connected(int port_index) const;
 
+  /**
+   * @brief Checks whether the update running the node has been cancelled.
+   *
+   * Long `compute` implementations can poll this flag and return early. Once
+   * the cancellation has been seen by `compute`, the node stays dirty.
+   *
+   * @return true If the cancellation has been requested.
+   */
+  bool is_cancel_requested() const;
+
   /**
    * @brief Check if a port is connected by its label.
    * @param port_label Label of the port.
@@ -315,6 +446,30 @@ public:
    */
   bool is_port_connected(const std::string &port_label) const;
 
+  /**
+   * @brief Prepare the outputs for a tiled update, e.g. resize them to the
+   * raster size, called once before the tiles are computed.
+   */
+  virtual void prepare_tiles() {}
+
+  /**
+   * @brief Set the cancellation token of the running update (managed by the
+   * graph).
+   *
+   * @param p_token Token, nullptr if the update cannot be cancelled.
+   */
+  void set_cancellation_token(const CancellationToken *p_token)
+  {
+    this->p_cancellation_token = p_token;
+  }
+
+  /**
+   * @brief Set the handle of the node within its graph (managed by the graph).
+   *
+   * @param new_handle Node handle.
+   */
+  void set_handle(NodeHandle new_handle) { this->handle = new_handle; }
+
   /**
    * @brief Set a new identifier for the node.
    *
@@ -334,6 +489,40 @@ public:
    */
   void set_input_data(std::shared_ptr<BaseData> data, int port_index);
 
+  /**
+   * @brief Let the node compute in place in the data of an input, see
+   * `take_input`.
+   *
+   * @param port_label The label of the input port.
+   * @param new_state Flag state.
+   */
+  void set_input_in_place(const std::string &port_label, bool new_state = true);
+
+  /**
+   * @brief Let an output publish a copy of its value each time the node has
+   * been computed, so that readers from other threads (e.g. previews drawn
+   * during an update) get a stable value through `get_snapshot` instead of
+   * reading the output while it is written.
+   *
+   * The value is copied in full each time the node is computed, a cost to
+   * weigh for large outputs (see `Output::publish`).
+   *
+   * @param port_label The label of the output port.
+   * @param new_state Flag state.
+   */
+  void set_output_double_buffered(const std::string &port_label,
+                                  bool               new_state = true);
+
+  /**
+   * @brief Keep the data of an output in memory whatever the memory budget
+   * of the graph (see `Graph::set_memory_budget`).
+   *
+   * @param port_label The label of the output port.
+   * @param new_state Pin state.
+   * @throw std::invalid_argument If the port is not an output.
+   */
+  void set_output_pinned(const std::string &port_label, bool new_state = true);
+
   /**
    * @brief Set the reference to the belonging graph.
    *
@@ -344,6 +533,9 @@ public:
   /**
    * @brief Set the value of a port by its label.
    *
+   * If the node belongs to a graph in reactive mode, the node is enqueued for
+   * the next coalesced update of the graph (except from within `compute`).
+   *
    * @tparam T The type of the value.
    * @param port_label The label of the port.
    * @param new_value The new value to set on the port.
@@ -356,15 +548,112 @@ public:
       throw std::runtime_error("set_value: port not found or type mismatch: " +
                                port_label);
     *p_value = new_value;
+
+    this->notify_value_change();
+  }
+
+  /**
+   * @brief Move the value of an input to an output, to be modified in place
+   * by `compute`.
+   *
+   * The value is moved if the input has been flagged with
+   * `set_input_in_place` and if the node is the only consumer of the upstream
+   * output, which is then released and recomputed if accessed again (see
+   * `Graph::release_input`). Otherwise the value is copied, the upstream
+   * output being left untouched. The input should not be read afterwards.
+   *
+   * @tparam T The type of the value.
+   * @param input_label The label of the input port.
+   * @param output_label The label of the output port.
+   * @return T* A pointer to the output value, or nullptr if the input is not
+   * connected.
+   */
+  template <typename T>
+  T *take_input(const std::string &input_label, const std::string &output_label)
+  {
+    const int in_index = this->get_port_index(input_label);
+    const int out_index = this->get_port_index(output_label);
+
+    auto p_in = in_index < 0 ? nullptr
+                             : std::dynamic_pointer_cast<Input<T>>(
+                                   this->ports[in_index]);
+    auto p_out = out_index < 0 ? nullptr
+                               : std::dynamic_pointer_cast<Output<T>>(
+                                     this->ports[out_index]);
+
+    if (!p_in || !p_out)
+      throw std::runtime_error("take_input: port not found or type mismatch: " +
+                               input_label + ", " + output_label);
+
+    T *p_value = p_in->get_value_ref();
+    if (!p_value) return nullptr;
+
+    if (p_in->is_in_place() && this->is_sole_consumer(in_index))
+    {
+      *p_out->get_value_ref() = std::move(*p_value);
+      this->release_input(in_index);
+    }
+    else if constexpr (std::is_copy_assignable_v<T>)
+      *p_out->get_value_ref() = *p_value;
+    else
+      throw std::runtime_error("take_input: value cannot be copied: " +
+                               input_label);
+
+    return p_out->get_value_ref();
   }
 
   /**
    * @brief Update the node, which involves processing its input and output
    * ports.
+   *
+   * If the graph has a result cache and the node provides a parameters hash,
+   * outputs cached for the same parameters and input data are restored
+   * instead of being computed.
+   *
+   * @param use_caches Whether the result and disk caches of the graph are
+   * looked up and filled (bypassed by `Graph::run`).
+   */
+  void update(bool use_caches = true);
+
+  /**
+   * @brief Compute the outputs of all the variants of a batch evaluation
+   * (managed by the graph).
+   *
+   * Nodes not implementing `compute_variants` are computed once per variant,
+   * their inputs being bound to the data of the variant and their outputs
+   * copied to the batch afterwards. The inputs are bound back to their
+   * original data, but the outputs of the node hold the values of the last
+   * variant.
+   *
+   * @param batch Data of the ports for each variant.
+   * @throw std::runtime_error If an output of a node computed once per
+   * variant cannot be copied.
    */
-  void update();
+  void update_variants(VariantBatch &batch);
 
 private:
+  /**
+   * @brief Enqueue the node for an update if its graph is in reactive mode.
+   */
+  void notify_value_change();
+
+  /**
+   * @brief Publish the values of the double-buffered outputs.
+   */
+  void publish_outputs();
+
+  /**
+   * @brief Checks whether the node is the only consumer of the data of an
+   * input, see `Graph::is_sole_consumer`.
+   */
+  bool is_sole_consumer(int port_index) const;
+
+  /**
+   * @brief Release the data of an input taken over by the node, see
+   * `Graph::release_input`.
+   */
+  void release_input(int port_index);
+
   /**
    * @brief The label of the node.
    */
@@ -375,6 +664,11 @@ private:
    */
   std::string id;
 
+  /**
+   * @brief The handle of the node within its graph.
+   */
+  NodeHandle handle;
+
   /**
    * @brief A vector of shared pointers to the node's ports.
    */
@@ -384,6 +678,21 @@ private:
    * @brief Reference to the graph the node belong to, if any.
    */
   Graph *p_graph = nullptr;
+
+  /**
+   * @brief Cancellation token of the running update, if any.
+   */
+  const CancellationToken *p_cancellation_token = nullptr;
+
+  /**
+   * @brief Whether the cancellation has been seen by the running computation.
+   */
+  mutable std::atomic<bool> is_compute_interrupted = false;
+
+  /**
+   * @brief Whether the node is running `compute`.
+   */
+  bool is_computing = false;
 };
 
 } // namespace gnode
@@ -0,0 +1,310 @@
+/* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+
+/**
+ * @file parameter_table.hpp
+ * @author Otto Link (otto.link.bv@gmail.com)
+ * @brief Defines the `ParameterTable` class, the value overrides of a batch
+ * evaluation, the `VariantBatch` class, the port data of a node for all the
+ * variants, and the `BatchResult` class, the outputs of each variant.
+ * @date 2023-08-07
+ *
+ * @copyright Copyright (c) 2023 Otto Link. Distributed under the terms of the
+ * GNU General Public License. See the file LICENSE for the full license.
+ */
+
+#pragma once
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gnode/data.hpp"
+
+namespace gnode
+{
+
+/**
+ * @struct ParameterColumn
+ * @brief Values of an output port overridden by a `ParameterTable`.
+ */
+struct ParameterColumn
+{
+  std::string node_id;    ///< ID of the node.
+  std::string port_label; ///< Label of the output port.
+
+  /**
+   * @brief Value of each variant, nullptr to keep the value of the graph.
+   */
+  std::vector<std::shared_ptr<BaseData>> values;
+};
+
+/**
+ * @class ParameterTable
+ * @brief Output values overridden by each variant of a batch evaluation (see
+ * `Graph::evaluate_batch`), typically the values of `Value`-like nodes.
+ */
+class ParameterTable
+{
+public:
+  /**
+   * @brief Constructs a table without overrides.
+   *
+   * @param variant_count Number of variants.
+   */
+  explicit ParameterTable(size_t variant_count) : variant_count(variant_count)
+  {
+  }
+
+  /**
+   * @brief Get the overridden ports, in the order of their first override.
+   */
+  const std::vector<ParameterColumn> &get_columns() const
+  {
+    return this->columns;
+  }
+
+  /**
+   * @brief Get the number of variants.
+   */
+  size_t get_variant_count() const { return this->variant_count; }
+
+  /**
+   * @brief Override the value of an output port for a variant.
+   *
+   * @tparam T The type of the value.
+   * @param variant Variant index.
+   * @param node_id ID of the node.
+   * @param port_label Label of the output port.
+   * @param value Value of the port for the variant.
+   * @throw std::out_of_range If the variant index is out of range.
+   */
+  template <typename T>
+  void set_value(size_t             variant,
+                 const std::string &node_id,
+                 const std::string &port_label,
+                 const T           &value)
+  {
+    if (variant >= this->variant_count)
+      throw std::out_of_range("ParameterTable::set_value: variant " +
+                              std::to_string(variant) + " out of range");
+
+    this->get_column(node_id, port_label).values[variant] = make_data<T>(value);
+  }
+
+private:
+  /**
+   * @brief Get the column of a port, added if not found.
+   */
+  ParameterColumn &get_column(const std::string &node_id,
+                              const std::string &port_label);
+
+  /**
+   * @brief Number of variants.
+   */
+  size_t variant_count;
+
+  /**
+   * @brief Overridden ports.
+   */
+  std::vector<ParameterColumn> columns;
+};
+
+/**
+ * @class VariantBatch
+ * @brief Data of the ports of a node for all the variants of a batch
+ * evaluation (see `Node::compute_variants`), the data of the variants of a port
+ * being stored side by side.
+ *
+ * The inputs that do not depend on the overridden values share the same data
+ * for all the variants, and unconnected inputs hold nullptr. The outputs hold
+ * a separate copy of the node output data for each variant, to be written by
+ * the node.
+ */
+class VariantBatch
+{
+public:
+  /**
+   * @brief Constructs a batch without data.
+   *
+   * @param variant_count Number of variants.
+   * @param port_count Number of ports of the node.
+   */
+  VariantBatch(size_t variant_count = 0, size_t port_count = 0)
+      : variant_count(variant_count),
+        data(port_count,
+             std::vector<std::shared_ptr<BaseData>>(variant_count))
+  {
+  }
+
+  /**
+   * @brief Get the data of a port for a variant.
+   *
+   * @param port_index Index of the port.
+   * @param variant Variant index.
+   * @return The data, nullptr for an unconnected input.
+   */
+  const std::shared_ptr<BaseData> &get_base_data(int    port_index,
+                                                 size_t variant) const
+  {
+    return this->data[port_index][variant];
+  }
+
+  /**
+   * @brief Get the number of variants.
+   */
+  size_t get_variant_count() const { return this->variant_count; }
+
+  /**
+   * @brief Get the value of a port for a variant.
+   *
+   * @tparam T The type of the value.
+   * @param port_index Index of the port.
+   * @param variant Variant index.
+   * @return A pointer to the value, or nullptr for an unconnected input or on
+   * type mismatch.
+   */
+  template <typename T> T *get_value_ref(int port_index, size_t variant) const
+  {
+    auto *p_data = dynamic_cast<Data<T> *>(
+        this->data[port_index][variant].get());
+
+    return p_data ? p_data->get_value_ref() : nullptr;
+  }
+
+  /**
+   * @brief Get the data of a port for all the variants.
+   *
+   * @param port_index Index of the port.
+   * @return The data of each variant.
+   */
+  const std::vector<std::shared_ptr<BaseData>> &get_variants(
+      int port_index) const
+  {
+    return this->data[port_index];
+  }
+
+  /**
+   * @brief Set the data of a port for all the variants (managed by the
+   * graph).
+   *
+   * @param port_index Index of the port.
+   * @param variants The data of each variant.
+   */
+  void set_variants(int                                    port_index,
+                    std::vector<std::shared_ptr<BaseData>> variants)
+  {
+    this->data[port_index] = std::move(variants);
+  }
+
+private:
+  /**
+   * @brief Number of variants.
+   */
+  size_t variant_count;
+
+  /**
+   * @brief Data of each variant, by port index.
+   */
+  std::vector<std::vector<std::shared_ptr<BaseData>>> data;
+};
+
+/**
+ * @class BatchResult
+ * @brief Outputs of the variants of a batch evaluation, the values of all the
+ * variants of a port being stored side by side.
+ */
+class BatchResult
+{
+public:
+  /**
+   * @brief Constructs an empty result.
+   *
+   * @param variant_count Number of variants.
+   */
+  explicit BatchResult(size_t variant_count = 0) : variant_count(variant_count)
+  {
+  }
+
+  /**
+   * @brief Get the output data of a variant.
+   *
+   * @param variant Variant index.
+   * @param node_id ID of the node.
+   * @param port_label Label of the output port.
+   * @return The data, or nullptr if the port has not been evaluated or if its
+   * value cannot be copied.
+   */
+  std::shared_ptr<BaseData> get_base_data(size_t             variant,
+                                          const std::string &node_id,
+                                          const std::string &port_label) const;
+
+  /**
+   * @brief Get the output value of a variant.
+   *
+   * @tparam T The type of the value.
+   * @param variant Variant index.
+   * @param node_id ID of the node.
+   * @param port_label Label of the output port.
+   * @return A pointer to the value, or nullptr if not found or on type
+   * mismatch.
+   */
+  template <typename T>
+  const T *get_value_ref(size_t             variant,
+                         const std::string &node_id,
+                         const std::string &port_label) const
+  {
+    auto p_data = std::dynamic_pointer_cast<Data<T>>(
+        this->get_base_data(variant, node_id, port_label));
+
+    return p_data ? p_data->get_value_ref() : nullptr;
+  }
+
+  /**
+   * @brief Get the output data of all the variants.
+   *
+   * @param node_id ID of the node.
+   * @param port_label Label of the output port.
+   * @return The data of each variant, empty if the port has not been
+   * evaluated.
+   */
+  std::vector<std::shared_ptr<BaseData>> get_variants(
+      const std::string &node_id,
+      const std::string &port_label) const;
+
+  /**
+   * @brief Get the number of variants.
+   */
+  size_t get_variant_count() const { return this->variant_count; }
+
+  /**
+   * @brief Set the output data of a variant.
+   *
+   * @param variant Variant index.
+   * @param node_id ID of the node.
+   * @param port_label Label of the output port.
+   * @param p_data Data.
+   */
+  void set_base_data(size_t                    variant,
+                     const std::string        &node_id,
+                     const std::string        &port_label,
+                     std::shared_ptr<BaseData> p_data);
+
+private:
+  /**
+   * @brief Number of variants.
+   */
+  size_t variant_count;
+
+  /**
+   * @brief Data of each variant, by node ID and port label.
+   */
+  std::map<std::pair<std::string, std::string>,
+           std::vector<std::shared_ptr<BaseData>>>
+      outputs;
+};
+
+} // namespace gnode
@@ -18,6 +18,8 @@
 #include "gnode/data.hpp"
 #include "gnode/logger.hpp"
 #include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <string>
 #include <typeinfo>
 
@@ -35,6 +37,18 @@ enum PortType
   OUT ///< Represents an output port.
 };
 
+/**
+ * @brief Published value of a double-buffered output, see
+ * `Output::get_snapshot`.
+ *
+ * @tparam T The data type.
+ */
+template <typename T> struct Snapshot
+{
+  std::shared_ptr<const T> value;       ///< Value, nullptr if not published.
+  uint64_t                 version = 0; ///< Publication count of the output.
+};
+
 /**
  * @brief Abstract base class representing a port in a node.
  *
@@ -61,10 +75,21 @@ public:
   virtual ~Port() = default;
 
   /**
-   * @brief Retrieves the type name of the data handled by this port.
+   * @brief Retrieves the readable type name of the data handled by this port,
+   * demangled on first request (see `get_type_pretty_name`).
    * @return A string representing the type name.
    */
-  std::string get_data_type() const { return this->data_type; }
+  std::string get_data_type() const
+  {
+    return get_type_pretty_name(this->data_type_id);
+  }
+
+  /**
+   * @brief Retrieves the identifier of the type of the data handled by this
+   * port.
+   * @return The type identifier, 0 if the port has no type.
+   */
+  TypeId get_data_type_id() const { return this->data_type_id; }
 
   /**
    * @brief Retrieves the label of the port.
@@ -92,6 +117,20 @@ public:
    */
   virtual PortType get_port_type() const = 0;
 
+  /**
+   * @brief Checks whether the port publishes its value to readers, see
+   * `set_double_buffered`.
+   * @return True if the port is double-buffered.
+   */
+  bool is_double_buffered() const { return this->double_buffered; }
+
+  /**
+   * @brief Checks whether the node computes in place in the data of this
+   * input port, see `set_in_place`.
+   * @return True if the data can be taken over by the node.
+   */
+  bool is_in_place() const { return this->in_place; }
+
   /**
    * @brief Retrieves a `void*` reference to the data value stored in this
    * output port.
@@ -106,11 +145,39 @@ public:
    */
   virtual void set_data(std::shared_ptr<BaseData> /* data */) {}
 
+  /**
+   * @brief Publish the value of a double-buffered output port, once computed.
+   */
+  virtual void publish() {}
+
+  /**
+   * @brief Let an output port publish a copy of its value each time its node
+   * has been computed, read through `Output::get_snapshot` without waiting
+   * for or interfering with the updates (e.g. from a UI thread). Only
+   * meaningful for output ports, to be set outside of the updates.
+   * @param new_state Flag state.
+   */
+  void set_double_buffered(bool new_state)
+  {
+    this->double_buffered = new_state;
+  }
+
+  /**
+   * @brief Allows the node to take over the data of this input port, moved to
+   * one of its outputs and modified in place rather than copied, when the
+   * node is the only consumer of the data (see `Node::take_input`). Only
+   * meaningful for input ports.
+   * @param new_state Flag state.
+   */
+  void set_in_place(bool new_state) { this->in_place = new_state; }
+
 protected:
-  std::string data_type; ///< A string representing the type name.
+  TypeId data_type_id = 0; ///< The identifier of the type of the data.
 
 private:
-  std::string label = "no label"; ///< The label of the port.
+  std::string label = "no label";      ///< The label of the port.
+  bool        in_place = false;        ///< In-place computation flag.
+  bool        double_buffered = false; ///< Double buffering flag.
 };
 
 /**
@@ -133,13 +200,33 @@ public:
    * @brief Constructs an Input port with the specified label.
    * @param label A string representing the label of the input port.
    */
-  Input(std::string label) : Port(label) { this->data_type = typeid(T).name(); }
+  Input(std::string label) : Port(label)
+  {
+    this->data_type_id = get_type_id<T>();
+  }
 
   /**
    * @brief Virtual destructor for Input.
    */
   virtual ~Input() = default;
 
+  /**
+   * @brief Retrieves a shared pointer to the data the input port points to.
+   * @return A shared pointer to the BaseData, or nullptr if the port is not
+   * connected.
+   */
+  std::shared_ptr<BaseData> get_data_shared_ptr_downcasted() const override
+  {
+    return std::static_pointer_cast<BaseData>(this->data.lock());
+  }
+
+  /**
+   * @brief Retrieves the data the input port points to, without reference
+   * counting (see `InPort`).
+   * @return A pointer to the data, or nullptr if the port is not connected.
+   */
+  Data<T> *get_data_ref() const { return this->p_data; }
+
   /**
    * @brief Returns the type of the port as an input port.
    *
@@ -191,12 +278,21 @@ public:
    */
   void set_data(std::shared_ptr<BaseData> data) override
   {
-    this->data = std::dynamic_pointer_cast<Data<T>>(std::move(data));
+    auto p_typed = std::dynamic_pointer_cast<Data<T>>(std::move(data));
+
+    this->p_data = p_typed.get();
+    this->data = std::move(p_typed);
   }
 
 private:
   std::weak_ptr<Data<T>>
       data; ///< A weak pointer to the data associated with this input port.
+
+  /**
+   * @brief Data the port points to, kept in sync with `data` (the data being
+   * owned by the linked output, unlinked before being released).
+   */
+  Data<T> *p_data = nullptr;
 };
 
 /**
@@ -213,9 +309,9 @@ public:
   /**
    * @brief Default constructor for Output.
    */
-  Output() : data(std::make_shared<Data<T>>())
+  Output() : data(make_data<T>())
   {
-    this->data_type = typeid(T).name();
+    this->data_type_id = get_type_id<T>();
   }
 
   /**
@@ -228,14 +324,14 @@ public:
    *
    * This constructor initializes an `Output` port with a given `label` and
    * forwards any additional arguments to the `Data<T>` constructor using
-   * `std::make_shared`.
+   * `make_data`.
    */
   template <typename... Args>
   explicit Output(std::string label, Args &&...args)
       : Port(label),
-        data(std::make_shared<Data<T>>(std::forward<Args>(args)...))
+        data(make_data<T>(std::forward<Args>(args)...))
   {
-    this->data_type = typeid(T).name();
+    this->data_type_id = get_type_id<T>();
   }
 
   /**
@@ -253,12 +349,6 @@ public:
     return std::static_pointer_cast<BaseData>(this->data);
   }
 
-  /**
-   * @brief Retrieves the type name of the data handled by this output port.
-   * @return A string representing the type name.
-   */
-  std::string get_data_type() const { return typeid(T).name(); }
-
   /**
    * @brief Returns the type of the port as an output port.
    *
@@ -291,9 +381,204 @@ public:
     return static_cast<void *>(this->data->get_value_ref());
   } ///< @overload
 
+  /**
+   * @brief Retrieves the last published value of a double-buffered output.
+   *
+   * Can be called from any thread while the node is being computed, the
+   * value being a stable copy kept alive by the snapshot.
+   *
+   * @return The snapshot, empty if no value has been published yet.
+   */
+  Snapshot<T> get_snapshot() const
+  {
+    std::shared_ptr<const Frame> p_frame;
+
+    {
+      std::lock_guard<std::mutex> lock(this->front_mutex);
+      p_frame = this->front;
+    }
+
+    if (!p_frame) return {};
+
+    return {std::shared_ptr<const T>(p_frame, &p_frame->value),
+            p_frame->version};
+  }
+
+  /**
+   * @brief Publish a copy of the value, if double-buffered.
+   *
+   * Each publication makes a full copy of the value into a new frame, its
+   * storage allocated from the buffer pool, which then replaces the published
+   * frame, only the pointer swap being guarded. The previous frame is
+   * released with its last snapshot.
+   */
+  void publish() override
+  {
+    if constexpr (std::is_copy_constructible_v<T>)
+    {
+      if (!this->is_double_buffered()) return;
+
+      // the previous frame is released out of the lock
+      std::shared_ptr<const Frame> p_frame = std::allocate_shared<Frame>(
+          PoolAllocator<Frame>(),
+          *this->data->get_value_ref(),
+          ++this->version);
+
+      std::lock_guard<std::mutex> lock(this->front_mutex);
+      this->front.swap(p_frame);
+    }
+  }
+
 private:
+  /**
+   * @brief Published value.
+   */
+  struct Frame
+  {
+    Frame(const T &value, uint64_t version) : value(value), version(version)
+    {
+    }
+
+    T        value;
+    uint64_t version;
+  };
+
   std::shared_ptr<Data<T>>
       data; ///< A shared pointer to the data associated with this output port.
+
+  std::shared_ptr<const Frame> front;       ///< Published value.
+  mutable std::mutex           front_mutex; ///< Guards the published value.
+  uint64_t                     version = 0; ///< Publication count.
+};
+
+/**
+ * @brief Typed handle to an input port, to be stored by the node (see
+ * `Node::add_port`).
+ *
+ * Reading the value through the handle costs a few pointer loads, without
+ * label lookup, type check or reference counting. The input is unbound when
+ * its link is removed and when the graph is cleared or destroyed, so that the
+ * handle never reads the data of a released output.
+ *
+ * @tparam T The data type.
+ */
+template <typename T> class InPort
+{
+public:
+  InPort() = default;
+
+  /**
+   * @brief Constructs a handle to an input port.
+   * @param p_port The port, owned by its node.
+   */
+  explicit InPort(Input<T> *p_port) : p_port(p_port) {}
+
+  /**
+   * @brief Retrieves the value of the port.
+   * @return A pointer to the value, or nullptr if the port is not connected.
+   */
+  T *get() const
+  {
+    Data<T> *p_data = this->p_port->get_data_ref();
+    return p_data ? p_data->get_value_ref() : nullptr;
+  }
+
+  T *operator->() const { return this->get(); } ///< @overload
+  T &operator*() const { return *this->get(); } ///< @overload
+
+  /**
+   * @brief Checks whether the port is connected.
+   */
+  explicit operator bool() const
+  {
+    return this->p_port->get_data_ref() != nullptr;
+  }
+
+private:
+  Input<T> *p_port = nullptr; ///< Handled port.
+};
+
+/**
+ * @brief Typed handle to an output port, to be stored by the node (see
+ * `Node::add_port`).
+ *
+ * The handle points to the output data directly, the data of an output being
+ * kept for the whole life of the port.
+ *
+ * @tparam T The data type.
+ */
+template <typename T> class OutPort
+{
+public:
+  OutPort() = default;
+
+  /**
+   * @brief Constructs a handle to the data of an output port.
+   * @param p_data The data, owned by the port.
+   */
+  explicit OutPort(Data<T> *p_data) : p_data(p_data) {}
+
+  /**
+   * @brief Retrieves the value of the port.
+   * @return A pointer to the value.
+   */
+  T *get() const { return this->p_data->get_value_ref(); }
+
+  T *operator->() const { return this->get(); } ///< @overload
+  T &operator*() const { return *this->get(); } ///< @overload
+
+private:
+  Data<T> *p_data = nullptr; ///< Data of the handled port.
+};
+
+/**
+ * @brief Port returned by `Node::add_port`, converted to the typed handle of
+ * its direction.
+ *
+ * @tparam T The data type.
+ */
+template <typename T> class PortRef
+{
+public:
+  /**
+   * @brief Constructs a reference to a port.
+   * @param p_port The port, owned by its node.
+   */
+  explicit PortRef(Port *p_port) : p_port(p_port) {}
+
+  /**
+   * @brief Converts to an input handle.
+   * @throw std::invalid_argument If the port is not an input of type T.
+   */
+  operator InPort<T>() const
+  {
+    auto *p_input = dynamic_cast<Input<T> *>(this->p_port);
+
+    if (!p_input)
+      throw std::invalid_argument("PortRef: not an input port: " +
+                                  this->p_port->get_label());
+
+    return InPort<T>(p_input);
+  }
+
+  /**
+   * @brief Converts to an output handle.
+   * @throw std::invalid_argument If the port is not an output of type T.
+   */
+  operator OutPort<T>() const
+  {
+    auto *p_output = dynamic_cast<Output<T> *>(this->p_port);
+
+    if (!p_output)
+      throw std::invalid_argument("PortRef: not an output port: " +
+                                  this->p_port->get_label());
+
+    return OutPort<T>(static_cast<Data<T> *>(
+        p_output->get_data_shared_ptr_downcasted().get()));
+  }
+
+private:
+  Port *p_port; ///< Referenced port.
 };
 
 } // namespace gnode
@@ -0,0 +1,178 @@
+/* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+
+/**
+ * @file result_cache.hpp
+ * @author Otto Link (otto.link.bv@gmail.com)
+ * @brief Defines the `ResultCache` class, an in-memory cache of node outputs
+ * addressed by the node type, parameters and input data.
+ * @date 2023-08-07
+ *
+ * @copyright Copyright (c) 2023 Otto Link. Distributed under the terms of the
+ * GNU General Public License. See the file LICENSE for the full license.
+ */
+
+#pragma once
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gnode/data.hpp"
+
+namespace gnode
+{
+
+/**
+ * @struct CacheKey
+ * @brief Content address of a node computation.
+ */
+struct CacheKey
+{
+  std::string           node_label;          ///< Node type.
+  uint64_t              parameters_hash = 0; ///< Hash of the node parameters.
+  std::vector<uint64_t> input_hashes;        ///< Hash of each input data.
+
+  bool operator==(const CacheKey &other) const = default;
+
+  /**
+   * @brief Hash of the whole key.
+   */
+  uint64_t get_hash() const;
+};
+
+/**
+ * @struct CacheStats
+ * @brief Usage statistics of a `ResultCache`.
+ */
+struct CacheStats
+{
+  size_t hits = 0;      ///< Number of computations restored from the cache.
+  size_t misses = 0;    ///< Number of lookups without result.
+  size_t evictions = 0; ///< Number of entries evicted to fit the budget.
+  size_t entries = 0;   ///< Number of entries stored.
+  size_t bytes = 0;     ///< Memory used by the stored entries.
+};
+
+/**
+ * @class ResultCache
+ * @brief Cache of node outputs, evicting the least recently used entries
+ * beyond a memory budget.
+ *
+ * Entries hold copies of the output data of a computation, restored into the
+ * output data of a node computing again with the same parameters and inputs
+ * (see `Node::get_parameters_hash`). A cache can be shared between graphs and
+ * is safe to use from the threads of a parallel executor.
+ */
+class ResultCache
+{
+public:
+  /**
+   * @brief Constructs a cache.
+   *
+   * @param byte_budget Maximum memory used by the entries, in bytes.
+   */
+  explicit ResultCache(size_t byte_budget = 256 << 20)
+      : byte_budget(byte_budget)
+  {
+  }
+
+  /**
+   * @brief Remove all the entries, the statistics being kept.
+   */
+  void clear();
+
+  /**
+   * @brief Get the memory budget, in bytes.
+   */
+  size_t get_byte_budget() const;
+
+  /**
+   * @brief Get the usage statistics.
+   */
+  CacheStats get_stats() const;
+
+  /**
+   * @brief Reset the hit, miss and eviction counters.
+   */
+  void reset_stats();
+
+  /**
+   * @brief Copy the outputs cached for a key into some output data.
+   *
+   * @param key Computation key.
+   * @param outputs Output data, in port order.
+   * @return true If the key has been found and the outputs restored.
+   */
+  bool restore(const CacheKey                                &key,
+               const std::vector<std::shared_ptr<BaseData>> &outputs);
+
+  /**
+   * @brief Set the memory budget, entries being evicted to fit in.
+   *
+   * @param new_budget Budget, in bytes.
+   */
+  void set_byte_budget(size_t new_budget);
+
+  /**
+   * @brief Store a copy of some output data.
+   *
+   * Nothing is stored if an output cannot be copied or if the outputs do not
+   * fit in the budget.
+   *
+   * @param key Computation key.
+   * @param outputs Output data, in port order.
+   */
+  void store(const CacheKey                                &key,
+             const std::vector<std::shared_ptr<BaseData>> &outputs);
+
+private:
+  struct Entry
+  {
+    CacheKey                               key;
+    std::vector<std::shared_ptr<BaseData>> outputs;
+    size_t                                 bytes = 0;
+  };
+
+  struct KeyHasher
+  {
+    size_t operator()(const CacheKey &key) const { return key.get_hash(); }
+  };
+
+  /**
+   * @brief Evict the least recently used entries beyond the budget (lock
+   * held).
+   */
+  void evict();
+
+  /**
+   * @brief Entries, most recently used first.
+   */
+  std::list<Entry> entries;
+
+  /**
+   * @brief Entry lookup by key.
+   */
+  std::unordered_map<CacheKey, std::list<Entry>::iterator, KeyHasher> index;
+
+  /**
+   * @brief Memory budget, in bytes.
+   */
+  size_t byte_budget;
+
+  /**
+   * @brief Usage statistics.
+   */
+  CacheStats stats;
+
+  /**
+   * @brief Guards the entries and the statistics.
+   */
+  mutable std::mutex mutex;
+};
+
+} // namespace gnode
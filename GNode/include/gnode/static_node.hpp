@@ -0,0 +1,138 @@
+/* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+
+/**
+ * @file static_node.hpp
+ * @author Otto Link (otto.link.bv@gmail.com)
+ * @brief Defines the `StaticNode` class template, a node whose ports are
+ * declared at compile time and whose computation receives typed references.
+ * @date 2023-08-07
+ *
+ * @copyright Copyright (c) 2023 Otto Link. Distributed under the terms of the
+ * GNU General Public License. See the file LICENSE for the full license.
+ */
+
+#pragma once
+#include <array>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include "gnode/node.hpp"
+
+namespace gnode
+{
+
+/**
+ * @brief Input types of a `StaticNode`, in port order.
+ */
+template <typename... Ts> struct Inputs
+{
+};
+
+/**
+ * @brief Output types of a `StaticNode`, in port order.
+ */
+template <typename... Ts> struct Outputs
+{
+};
+
+template <typename Derived, typename InputList, typename OutputList>
+class StaticNode; // undefined, see the specialization below
+
+/**
+ * @brief Node whose ports are declared at compile time (CRTP).
+ *
+ * The derived class provides a `compute` method taking the input values by
+ * const reference followed by the output values by reference, e.g.
+ *
+ * @code
+ * class Add : public StaticNode<Add, Inputs<float, float>, Outputs<float>>
+ * {
+ * public:
+ *   Add() : StaticNode("Add", {"a", "b"}, {"a + b"}) {}
+ *
+ *   void compute(const float &a, const float &b, float &out) { out = a + b; }
+ * };
+ * @endcode
+ *
+ * The ports are regular ports, linked and accessed as those of any other
+ * node, but the arguments are bound through typed port handles, without
+ * label lookup, virtual call or cast. The computation is skipped while an
+ * input is not connected, the outputs keeping their values.
+ *
+ * @tparam Derived The derived node class.
+ * @tparam Is The input types.
+ * @tparam Os The output types.
+ */
+template <typename Derived, typename... Is, typename... Os>
+class StaticNode<Derived, Inputs<Is...>, Outputs<Os...>> : public Node
+{
+public:
+  /**
+   * @brief Constructs the node and its ports.
+   *
+   * @param label The label of the node.
+   * @param input_labels The labels of the inputs, in port order.
+   * @param output_labels The labels of the outputs, in port order.
+   */
+  StaticNode(std::string                                 label,
+             const std::array<std::string, sizeof...(Is)> &input_labels,
+             const std::array<std::string, sizeof...(Os)> &output_labels)
+      : Node(std::move(label))
+  {
+    this->add_ports(input_labels,
+                    output_labels,
+                    std::index_sequence_for<Is...>(),
+                    std::index_sequence_for<Os...>());
+  }
+
+  /**
+   * @brief Calls the typed `compute` of the derived class.
+   */
+  void compute() final
+  {
+    this->call_compute(std::index_sequence_for<Is...>(),
+                       std::index_sequence_for<Os...>());
+  }
+
+private:
+  template <size_t... I, size_t... O>
+  void add_ports(const std::array<std::string, sizeof...(Is)> &input_labels,
+                 const std::array<std::string, sizeof...(Os)> &output_labels,
+                 std::index_sequence<I...>,
+                 std::index_sequence<O...>)
+  {
+    ((std::get<I>(this->inputs) = this->template add_port<Is>(
+          PortType::IN,
+          input_labels[I])),
+     ...);
+    ((std::get<O>(this->outputs) = this->template add_port<Os>(
+          PortType::OUT,
+          output_labels[O])),
+     ...);
+  }
+
+  template <size_t... I, size_t... O>
+  void call_compute(std::index_sequence<I...>, std::index_sequence<O...>)
+  {
+    if (!(static_cast<bool>(std::get<I>(this->inputs)) && ...)) return;
+
+    static_cast<Derived *>(this)->compute(
+        static_cast<const Is &>(*std::get<I>(this->inputs))...,
+        *std::get<O>(this->outputs)...);
+  }
+
+  /**
+   * @brief Handles of the input ports.
+   */
+  std::tuple<InPort<Is>...> inputs;
+
+  /**
+   * @brief Handles of the output ports.
+   */
+  std::tuple<OutPort<Os>...> outputs;
+};
+
+} // namespace gnode
@@ -0,0 +1,72 @@
+/* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+
+/**
+ * @file tiling.hpp
+ * @author Otto Link (otto.link.bv@gmail.com)
+ * @brief Defines the `TileRegion` and `TilingScheme` structures used by the
+ * tiled updates of raster nodes.
+ * @date 2023-08-07
+ *
+ * @copyright Copyright (c) 2023 Otto Link. Distributed under the terms of the
+ * GNU General Public License. See the file LICENSE for the full license.
+ */
+
+#pragma once
+#include <algorithm>
+
+namespace gnode
+{
+
+/**
+ * @struct TileRegion
+ * @brief Rectangular region of a raster, in cells, `x0` and `y0` included and
+ * `x1` and `y1` excluded.
+ */
+struct TileRegion
+{
+  int x0 = 0; ///< First column.
+  int y0 = 0; ///< First row.
+  int x1 = 0; ///< Column past the last one.
+  int y1 = 0; ///< Row past the last one.
+
+  bool operator==(const TileRegion &other) const = default;
+
+  /**
+   * @brief Region grown by a margin on each side, clipped to a raster.
+   *
+   * @param margin Margin, in cells.
+   * @param width Raster width.
+   * @param height Raster height.
+   */
+  TileRegion expanded(int margin, int width, int height) const
+  {
+    return {std::max(0, this->x0 - margin),
+            std::max(0, this->y0 - margin),
+            std::min(width, this->x1 + margin),
+            std::min(height, this->y1 + margin)};
+  }
+
+  /**
+   * @brief Number of cells of the region.
+   */
+  int get_area() const
+  {
+    return std::max(0, this->x1 - this->x0) * std::max(0, this->y1 - this->y0);
+  }
+};
+
+/**
+ * @struct TilingScheme
+ * @brief Tiling declared by a node computing its outputs region by region, see
+ * `Node::get_tiling`.
+ */
+struct TilingScheme
+{
+  int width = 0;  ///< Raster width of the outputs, in cells.
+  int height = 0; ///< Raster height of the outputs, in cells.
+  int halo = 0;   ///< Neighbourhood radius read around a cell on the inputs.
+};
+
+} // namespace gnode
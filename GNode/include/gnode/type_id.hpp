@@ -0,0 +1,71 @@
+/* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+
+/**
+ * @file type_id.hpp
+ * @author Otto Link (otto.link.bv@gmail.com)
+ * @brief Defines the `TypeId` interned identifiers of the data types handled
+ * by the ports.
+ * @date 2023-08-07
+ *
+ * @copyright Copyright (c) 2023 Otto Link. Distributed under the terms of the
+ * GNU General Public License. See the file LICENSE for the full license.
+ */
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <typeinfo>
+
+namespace gnode
+{
+
+/**
+ * @brief Interned identifier of a data type, compared in O(1) (0 for no
+ * type).
+ */
+using TypeId = uint32_t;
+
+/**
+ * @brief Get the identifier of a type, registered on first use.
+ *
+ * Types are interned by their `std::type_info`, so that a type keeps the same
+ * identifier across shared libraries.
+ *
+ * @param info The type information.
+ * @return TypeId The identifier.
+ */
+TypeId intern_type(const std::type_info &info);
+
+/**
+ * @brief Get the identifier of a type, see `intern_type`.
+ *
+ * @tparam T The type.
+ * @return TypeId The identifier, only looked up on the first call.
+ */
+template <typename T> TypeId get_type_id()
+{
+  static const TypeId id = intern_type(typeid(T));
+  return id;
+}
+
+/**
+ * @brief Get the implementation name of a type (`std::type_info::name`),
+ * stable across runs of the same build.
+ *
+ * @param id The type identifier.
+ * @return The name, empty for an unknown identifier.
+ */
+const std::string &get_type_name(TypeId id);
+
+/**
+ * @brief Get the readable name of a type, demangled on first request (for UI
+ * and logging purposes).
+ *
+ * @param id The type identifier.
+ * @return The name, empty for an unknown identifier.
+ */
+const std::string &get_type_pretty_name(TypeId id);
+
+} // namespace gnode
@@ -0,0 +1,192 @@
+/* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <functional>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#include "gnode/buffer_pool.hpp"
+
+namespace gnode
+{
+
+// aligned block, backed by huge pages if requested
+void *helper_allocate_block(size_t size, bool huge_pages)
+{
+#ifdef __linux__
+  if (huge_pages && size >= BufferPool::huge_page_size)
+  {
+    const size_t huge_size = (size + BufferPool::huge_page_size - 1) /
+                             BufferPool::huge_page_size *
+                             BufferPool::huge_page_size;
+
+    void *p = std::aligned_alloc(BufferPool::huge_page_size, huge_size);
+    if (p) madvise(p, huge_size, MADV_HUGEPAGE);
+    return p;
+  }
+#else
+  (void)huge_pages;
+#endif
+
+  return std::aligned_alloc(BufferPool::alignment, size);
+}
+
+BufferPool::~BufferPool() { this->shrink(0); }
+
+void *BufferPool::allocate(size_t bytes)
+{
+  const size_t size = BufferPool::get_class_size(bytes);
+  bool         huge_pages;
+
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    this->stats.allocations++;
+    this->stats.bytes_in_use += size;
+
+    auto it = this->free_lists.find(size);
+
+    if (it != this->free_lists.end() && !it->second.empty())
+    {
+      void *p = it->second.back();
+      it->second.pop_back();
+
+      this->stats.reuses++;
+      this->stats.bytes_cached -= size;
+      return p;
+    }
+
+    huge_pages = this->huge_pages;
+  }
+
+  void *p = helper_allocate_block(size, huge_pages);
+
+  if (!p)
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    this->stats.allocations--;
+    this->stats.bytes_in_use -= size;
+    throw std::bad_alloc();
+  }
+
+  return p;
+}
+
+void BufferPool::deallocate(void *p, size_t bytes) noexcept
+{
+  if (!p) return;
+
+  const size_t size = BufferPool::get_class_size(bytes);
+
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    this->stats.bytes_in_use -= size;
+
+    if (this->stats.bytes_cached + size <= this->cache_limit)
+    {
+      // growing the free list may throw, the block is then freed
+      try
+      {
+        this->free_lists[size].push_back(p);
+        this->stats.bytes_cached += size;
+        return;
+      }
+      catch (...)
+      {
+      }
+    }
+  }
+
+  std::free(p);
+}
+
+BufferPool &BufferPool::get_default()
+{
+  // never destroyed, blocks being possibly given back by static objects
+  // destroyed at exit
+  static BufferPool *p_pool = new BufferPool();
+  return *p_pool;
+}
+
+size_t BufferPool::get_cache_limit() const
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->cache_limit;
+}
+
+size_t BufferPool::get_class_size(size_t bytes)
+{
+  if (bytes <= BufferPool::alignment) return BufferPool::alignment;
+  if (bytes <= 4096) return std::bit_ceil(bytes);
+
+  // four classes per power of two, all multiples of the alignment
+  const size_t step = std::bit_floor(bytes - 1) / 4;
+  return (bytes + step - 1) / step * step;
+}
+
+BufferPoolStats BufferPool::get_stats() const
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->stats;
+}
+
+bool BufferPool::is_huge_pages() const
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->huge_pages;
+}
+
+void BufferPool::set_cache_limit(size_t new_limit)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+
+  this->cache_limit = new_limit;
+  this->shrink(new_limit);
+}
+
+void BufferPool::set_huge_pages(bool new_state)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->huge_pages = new_state;
+}
+
+void BufferPool::shrink(size_t limit)
+{
+  if (this->stats.bytes_cached <= limit) return;
+
+  std::vector<size_t> sizes;
+  for (const auto &[size, _] : this->free_lists)
+    sizes.push_back(size);
+
+  std::sort(sizes.begin(), sizes.end(), std::greater<size_t>());
+
+  for (size_t size : sizes)
+  {
+    std::vector<void *> &blocks = this->free_lists[size];
+
+    while (!blocks.empty() && this->stats.bytes_cached > limit)
+    {
+      std::free(blocks.back());
+      blocks.pop_back();
+      this->stats.bytes_cached -= size;
+    }
+
+    if (blocks.empty()) this->free_lists.erase(size);
+    if (this->stats.bytes_cached <= limit) break;
+  }
+}
+
+void BufferPool::trim()
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->shrink(0);
+}
+
+} // namespace gnode
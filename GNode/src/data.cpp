@@ -0,0 +1,79 @@
+/* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#include <fstream>
+
+#include "gnode/data.hpp"
+
+namespace gnode
+{
+
+bool BaseData::drop(std::function<void()> hook)
+{
+  if (this->pinned || this->get_residency() != DataResidency::RESIDENT)
+    return false;
+
+  if (!this->release()) return false;
+
+  this->restore_hook = std::move(hook);
+  this->residency.store(DataResidency::DROPPED, std::memory_order_release);
+  return true;
+}
+
+bool BaseData::reload()
+{
+  if (this->get_residency() != DataResidency::SPILLED) return false;
+
+  bool is_read;
+
+  {
+    std::ifstream is(this->spill_path, std::ios::binary);
+    is_read = is && this->deserialize(is);
+  }
+
+  if (!is_read) return false;
+
+  this->set_resident();
+  return true;
+}
+
+void BaseData::set_resident()
+{
+  if (!this->spill_path.empty())
+  {
+    std::error_code ec;
+    std::filesystem::remove(this->spill_path, ec);
+    this->spill_path.clear();
+  }
+
+  // the hook is kept, this method being called from the hook itself
+  this->residency.store(DataResidency::RESIDENT, std::memory_order_release);
+}
+
+bool BaseData::spill(const std::filesystem::path &path,
+                     std::function<void()>        hook)
+{
+  if (this->pinned || this->get_residency() != DataResidency::RESIDENT)
+    return false;
+
+  bool is_written;
+
+  {
+    std::ofstream os(path, std::ios::binary | std::ios::trunc);
+    is_written = os && this->serialize(os) && os.flush();
+  }
+
+  if (!is_written || !this->release())
+  {
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    return false;
+  }
+
+  this->spill_path = path;
+  this->restore_hook = std::move(hook);
+  this->residency.store(DataResidency::SPILLED, std::memory_order_release);
+  return true;
+}
+
+} // namespace gnode
@@ -0,0 +1,336 @@
+/* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <random>
+
+#include "gnode/disk_cache.hpp"
+#include "gnode/logger.hpp"
+
+namespace gnode
+{
+
+namespace fs = std::filesystem;
+
+static constexpr char        entry_magic[] = "GNODEC01";
+static constexpr size_t      entry_magic_size = sizeof(entry_magic) - 1;
+static constexpr const char *entry_extension = ".gnc";
+static constexpr const char *temp_extension = ".tmp";
+
+bool helper_read_u64(std::istream &is, uint64_t &value)
+{
+  return static_cast<bool>(
+      is.read(reinterpret_cast<char *>(&value), sizeof(uint64_t)));
+}
+
+void helper_write_u64(std::ostream &os, uint64_t value)
+{
+  os.write(reinterpret_cast<const char *>(&value), sizeof(uint64_t));
+}
+
+bool helper_read_string(std::istream &is, std::string &str)
+{
+  uint64_t size = 0;
+  if (!helper_read_u64(is, size) || size > (1u << 16)) return false;
+
+  str.resize(size);
+  return static_cast<bool>(is.read(str.data(), size));
+}
+
+void helper_write_string(std::ostream &os, const std::string &str)
+{
+  helper_write_u64(os, str.size());
+  os.write(str.data(), str.size());
+}
+
+// entry file name, hexadecimal hash of the key
+std::string helper_entry_name(const CacheKey &key)
+{
+  char buffer[17];
+  std::snprintf(buffer,
+                sizeof(buffer),
+                "%016llx",
+                static_cast<unsigned long long>(key.get_hash()));
+  return std::string(buffer) + entry_extension;
+}
+
+DiskCache::DiskCache(const fs::path &directory, size_t byte_limit)
+    : directory(directory), byte_limit(byte_limit)
+{
+  fs::create_directories(this->directory);
+
+  std::random_device rd;
+  this->temp_prefix = std::to_string(rd()) + "_";
+
+  // index the entries of the previous runs, the most recently used first,
+  // and remove the leftovers of interrupted writes
+  struct Found
+  {
+    std::string        name;
+    size_t             bytes;
+    fs::file_time_type time;
+  };
+
+  std::vector<Found> found;
+
+  for (const auto &item : fs::directory_iterator(this->directory))
+  {
+    if (!item.is_regular_file()) continue;
+
+    const fs::path &path = item.path();
+
+    if (path.extension() == temp_extension)
+    {
+      std::error_code ec;
+      fs::remove(path, ec);
+    }
+    else if (path.extension() == entry_extension)
+      found.push_back({path.filename().string(),
+                       static_cast<size_t>(item.file_size()),
+                       item.last_write_time()});
+  }
+
+  std::sort(found.begin(),
+            found.end(),
+            [](const Found &a, const Found &b) { return a.time > b.time; });
+
+  for (const auto &f : found)
+  {
+    this->entries.push_back({f.name, f.bytes});
+    this->index[f.name] = std::prev(this->entries.end());
+    this->stats.bytes += f.bytes;
+    this->stats.entries++;
+  }
+
+  this->evict();
+}
+
+void DiskCache::clear()
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+
+  while (!this->entries.empty())
+    this->remove(this->entries.back().name);
+}
+
+void DiskCache::evict()
+{
+  while (this->stats.bytes > this->byte_limit && !this->entries.empty())
+  {
+    this->remove(this->entries.back().name);
+    this->stats.evictions++;
+  }
+}
+
+size_t DiskCache::get_byte_limit() const
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->byte_limit;
+}
+
+CacheStats DiskCache::get_stats() const
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->stats;
+}
+
+void DiskCache::remove(const std::string &name)
+{
+  auto it = this->index.find(name);
+  if (it == this->index.end()) return;
+
+  // the name may be owned by the entry
+  const fs::path path = this->directory / name;
+
+  this->stats.bytes -= it->second->bytes;
+  this->stats.entries--;
+  this->entries.erase(it->second);
+  this->index.erase(it);
+
+  std::error_code ec;
+  fs::remove(path, ec);
+}
+
+void DiskCache::reset_stats()
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+
+  this->stats.hits = 0;
+  this->stats.misses = 0;
+  this->stats.evictions = 0;
+}
+
+bool DiskCache::restore(const CacheKey                               &key,
+                        const std::vector<std::shared_ptr<BaseData>> &outputs)
+{
+  const std::string name = helper_entry_name(key);
+  const fs::path    path = this->directory / name;
+
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    auto it = this->index.find(name);
+
+    if (it == this->index.end())
+    {
+      this->stats.misses++;
+      return false;
+    }
+
+    this->entries.splice(this->entries.begin(), this->entries, it->second);
+  }
+
+  // header: key and output types, followed by the output data
+  std::ifstream is(path, std::ios::binary);
+
+  char        magic[entry_magic_size];
+  CacheKey    stored_key;
+  uint64_t    count = 0;
+  std::string type;
+
+  bool is_valid = is.read(magic, entry_magic_size) &&
+                  std::equal(magic, magic + entry_magic_size, entry_magic) &&
+                  helper_read_string(is, stored_key.node_label) &&
+                  helper_read_u64(is, stored_key.parameters_hash) &&
+                  helper_read_u64(is, count) && count <= (1u << 16);
+
+  if (is_valid)
+  {
+    stored_key.input_hashes.resize(count);
+    for (auto &hash : stored_key.input_hashes)
+      is_valid = is_valid && helper_read_u64(is, hash);
+  }
+
+  // a hash collision or different outputs, the entry is replaced
+  const bool is_match = is_valid && stored_key == key &&
+                        helper_read_u64(is, count) && count == outputs.size();
+
+  for (size_t k = 0; is_match && k < outputs.size(); ++k)
+    is_valid = is_valid && outputs[k] && helper_read_string(is, type) &&
+               type == outputs[k]->get_type() &&
+               outputs[k]->deserialize(is);
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+
+  if (!is_valid || !is_match)
+  {
+    if (!is_valid)
+      Logger::log()->warn("DiskCache::restore: removing invalid entry {}",
+                          path.string());
+
+    this->remove(name);
+    this->stats.misses++;
+    return false;
+  }
+
+  // the modification time keeps track of the use order across runs
+  std::error_code ec;
+  fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+
+  this->stats.hits++;
+  return true;
+}
+
+void DiskCache::set_byte_limit(size_t new_limit)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+
+  this->byte_limit = new_limit;
+  this->evict();
+}
+
+void DiskCache::store(const CacheKey                               &key,
+                      const std::vector<std::shared_ptr<BaseData>> &outputs)
+{
+  const std::string name = helper_entry_name(key);
+  fs::path          temp_path;
+
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    // content-addressed, an entry with the same key holds the same data
+    auto it = this->index.find(name);
+
+    if (it != this->index.end())
+    {
+      this->entries.splice(this->entries.begin(), this->entries, it->second);
+      return;
+    }
+
+    temp_path = this->directory / (this->temp_prefix +
+                                   std::to_string(this->temp_count++) +
+                                   temp_extension);
+  }
+
+  // the entry is written to a temporary file, renamed once complete
+  bool is_written;
+
+  {
+    std::ofstream os(temp_path, std::ios::binary | std::ios::trunc);
+
+    os.write(entry_magic, entry_magic_size);
+    helper_write_string(os, key.node_label);
+    helper_write_u64(os, key.parameters_hash);
+    helper_write_u64(os, key.input_hashes.size());
+    for (uint64_t hash : key.input_hashes)
+      helper_write_u64(os, hash);
+
+    helper_write_u64(os, outputs.size());
+
+    is_written = static_cast<bool>(os);
+
+    for (const auto &p_data : outputs)
+    {
+      is_written = is_written && p_data;
+      if (!is_written) break;
+
+      helper_write_string(os, p_data->get_type());
+      is_written = p_data->serialize(os);
+    }
+
+    is_written = is_written && static_cast<bool>(os.flush());
+  }
+
+  std::error_code ec;
+  const size_t    bytes = is_written ? fs::file_size(temp_path, ec) : 0;
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+
+  if (!is_written || ec || bytes > this->byte_limit)
+  {
+    fs::remove(temp_path, ec);
+    return;
+  }
+
+  fs::rename(temp_path, this->directory / name, ec);
+
+  if (ec)
+  {
+    Logger::log()->warn("DiskCache::store: cannot write entry {}: {}",
+                        name,
+                        ec.message());
+    fs::remove(temp_path, ec);
+    return;
+  }
+
+  // entry stored meanwhile by another thread, the file has been replaced
+  auto it = this->index.find(name);
+
+  if (it != this->index.end())
+  {
+    this->stats.bytes -= it->second->bytes;
+    this->stats.entries--;
+    this->entries.erase(it->second);
+  }
+
+  this->entries.push_front({name, bytes});
+  this->index[name] = this->entries.begin();
+  this->stats.bytes += bytes;
+  this->stats.entries++;
+
+  this->evict();
+}
+
+} // namespace gnode
@@ -0,0 +1,191 @@
+/* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+#include "gnode/executor.hpp"
+
+namespace gnode
+{
+
+// ordering of the ready tasks heap, ties being broken by the task index to
+// follow the topological order
+bool helper_is_lower_priority(const std::vector<double> &priority,
+                              uint32_t                   a,
+                              uint32_t                   b)
+{
+  if (priority.empty() || priority[a] == priority[b]) return a > b;
+  return priority[a] < priority[b];
+}
+
+// === SerialExecutor ===
+
+void SerialExecutor::run(const TaskGraph                     &tasks,
+                         const std::function<void(uint32_t)> &task)
+{
+  // task indices already follow a topological order
+  for (uint32_t k = 0; k < tasks.size(); ++k)
+    task(k);
+}
+
+// === ThreadPoolExecutor ===
+
+struct ThreadPoolExecutor::Job
+{
+  const TaskGraph                         *p_tasks;
+  const std::function<void(uint32_t)>     *p_task;
+  std::unique_ptr<std::atomic<uint32_t>[]> pending;   ///< Unfinished inputs.
+  size_t                                   remaining; ///< Unfinished tasks.
+  std::exception_ptr                       error = nullptr;
+};
+
+ThreadPoolExecutor::ThreadPoolExecutor(size_t thread_count)
+{
+  if (thread_count == 0)
+    thread_count = std::max(1u, std::thread::hardware_concurrency());
+
+  this->workers.reserve(thread_count);
+
+  for (size_t k = 0; k < thread_count; ++k)
+    this->workers.emplace_back(&ThreadPoolExecutor::work, this);
+}
+
+ThreadPoolExecutor::~ThreadPoolExecutor()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->stop = true;
+  }
+  this->cv_ready.notify_all();
+
+  for (auto &worker : this->workers)
+    worker.join();
+}
+
+uint32_t ThreadPoolExecutor::pop_ready()
+{
+  const std::vector<double> &priority = this->p_job->p_tasks->priority;
+
+  auto lower = [&priority](uint32_t a, uint32_t b)
+  { return helper_is_lower_priority(priority, a, b); };
+
+  std::pop_heap(this->queue.begin(), this->queue.end(), lower);
+  const uint32_t task = this->queue.back();
+  this->queue.pop_back();
+
+  return task;
+}
+
+void ThreadPoolExecutor::push_ready(uint32_t task)
+{
+  const std::vector<double> &priority = this->p_job->p_tasks->priority;
+
+  auto lower = [&priority](uint32_t a, uint32_t b)
+  { return helper_is_lower_priority(priority, a, b); };
+
+  this->queue.push_back(task);
+  std::push_heap(this->queue.begin(), this->queue.end(), lower);
+}
+
+void ThreadPoolExecutor::run(const TaskGraph                     &tasks,
+                             const std::function<void(uint32_t)> &task)
+{
+  if (tasks.size() == 0) return;
+
+  std::lock_guard<std::mutex> run_lock(this->run_mutex);
+
+  Job job;
+  job.p_tasks = &tasks;
+  job.p_task = &task;
+  job.pending = std::make_unique<std::atomic<uint32_t>[]>(tasks.size());
+  job.remaining = tasks.size();
+
+  for (size_t k = 0; k < tasks.size(); ++k)
+    job.pending[k].store(tasks.in_degree[k], std::memory_order_relaxed);
+
+  {
+    std::unique_lock<std::mutex> lock(this->mutex);
+
+    this->p_job = &job;
+
+    for (uint32_t k = 0; k < tasks.size(); ++k)
+      if (tasks.in_degree[k] == 0) this->push_ready(k);
+
+    this->cv_ready.notify_all();
+    this->cv_done.wait(lock, [&job] { return job.remaining == 0; });
+
+    this->p_job = nullptr;
+  }
+
+  if (job.error) std::rethrow_exception(job.error);
+}
+
+void ThreadPoolExecutor::work()
+{
+  std::vector<uint32_t>        ready;
+  std::unique_lock<std::mutex> lock(this->mutex);
+
+  while (true)
+  {
+    this->cv_ready.wait(lock,
+                        [this] { return this->stop || !this->queue.empty(); });
+
+    if (this->queue.empty()) return;
+
+    Job           &job = *this->p_job;
+    const uint32_t k = this->pop_ready();
+    const bool     skip = job.error != nullptr;
+
+    lock.unlock();
+
+    // run the task, once a task failed the remaining ones are only counted
+    // down to let the job complete
+    std::exception_ptr error = nullptr;
+
+    if (!skip)
+    {
+      try
+      {
+        (*job.p_task)(k);
+      }
+      catch (...)
+      {
+        error = std::current_exception();
+      }
+    }
+
+    // release the successors whose inputs are all done
+    const TaskGraph &tasks = *job.p_tasks;
+
+    ready.clear();
+
+    for (uint32_t s = tasks.successor_offsets[k];
+         s < tasks.successor_offsets[k + 1];
+         ++s)
+    {
+      const uint32_t next = tasks.successors[s];
+
+      if (job.pending[next].fetch_sub(1, std::memory_order_acq_rel) == 1)
+        ready.push_back(next);
+    }
+
+    lock.lock();
+
+    if (error && !job.error) job.error = error;
+
+    for (uint32_t next : ready)
+      this->push_ready(next);
+
+    if (ready.size() == 1)
+      this->cv_ready.notify_one();
+    else if (ready.size() > 1)
+      this->cv_ready.notify_all();
+
+    if (--job.remaining == 0) this->cv_done.notify_all();
+  }
+}
+
+} // namespace gnode
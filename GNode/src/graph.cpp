@@ -2,10 +2,14 @@
  * Public License. The full license is in the file LICENSE, distributed with
  * this software. */
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
-#include <queue>
+#include <mutex>
+#include <numeric>
+#include <random>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wsign-compare"
@@ -24,16 +28,84 @@
 namespace gnode
 {
 
-void helper_mark_dirty(
-    const std::string                                     &node_id,
-    std::vector<std::string>                              &visited,
-    const std::map<std::string, std::vector<std::string>> &connectivity_dw)
+// nodes computed tile by tile by an update, see Graph::set_tile_size
+struct TiledGroup
 {
-  if (contains(visited, node_id)) return;
+  std::vector<uint32_t> members;        // tasks, in topological order
+  std::vector<int>      halos;          // halo of each node
+  std::vector<int>      reach;          // margin computed around the tiles
+  TilingScheme          tiling;         // raster shared by the nodes
+  int                   nx = 0;         // number of tiles along x
+  int                   ny = 0;         // number of tiles along y
+  int                   phases = 1;     // number of tile phases
+  uint32_t              first_item = 0; // preparation item
+  uint32_t              last_item = 0;  // last barrier item
+};
+
+// unit of work of an update, a node update or a step of a tiled group
+struct UpdateItem
+{
+  enum Kind
+  {
+    NODE,    // node update, index being the node task
+    PREPARE, // preparation of a tiled group, index being the group
+    TILE,    // tile of a tiled group
+    BARRIER  // end of a phase of the tiles of a tiled group
+  };
+
+  Kind     kind;
+  uint32_t index;
+  int      tile; // tile for a tile, phase for a barrier
+};
+
+// core region of a tile
+TileRegion helper_get_tile(const TiledGroup &group, int tile_size, int tile)
+{
+  const int tx = tile % group.nx;
+  const int ty = tile / group.nx;
+
+  return {tx * tile_size,
+          ty * tile_size,
+          std::min(group.tiling.width, (tx + 1) * tile_size),
+          std::min(group.tiling.height, (ty + 1) * tile_size)};
+}
+
+// inputs read the data of the linked outputs through raw pointers (see
+// InPort), unbound before the nodes are released by the graph
+void helper_unbind_inputs(Node &node)
+{
+  for (int k = 0; k < node.get_nports(); ++k)
+    if (node.get_ports()[k]->get_port_type() == PortType::IN)
+      node.set_input_data(nullptr, k);
+}
+
+// phase of a tile, the tiles of a phase being two tiles apart when there are
+// four phases
+int helper_get_tile_phase(const TiledGroup &group, int tile)
+{
+  if (group.phases == 1) return 0;
+  if (group.phases == 4)
+    return (tile % group.nx) % 2 + 2 * ((tile / group.nx) % 2);
+  return tile;
+}
+
+Graph::~Graph()
+{
+  this->cancel_update();
+  this->wait_update();
+
+  // the restore hooks of the evicted outputs point to the graph
+  for (auto &[_, p_node] : this->nodes)
+  {
+    this->discard_evicted_outputs(p_node.get());
+    helper_unbind_inputs(*p_node);
+  }
 
-  visited.push_back(node_id);
-  for (const auto &dw_id : connectivity_dw.at(node_id))
-    helper_mark_dirty(dw_id, visited, connectivity_dw);
+  if (!this->spill_directory.empty())
+  {
+    std::error_code ec;
+    std::filesystem::remove_all(this->spill_directory, ec);
+  }
 }
 
 std::string Graph::add_node(const std::shared_ptr<Node> &p_node,
@@ -52,19 +124,178 @@ std::string Graph::add_node(const std::shared_ptr<Node> &p_node,
   this->nodes[node_id] = p_node;
   p_node->set_id(node_id);
 
+  // Store the node in a free slot and hand its handle over to the node
+  uint32_t index;
+
+  if (this->free_slots.empty())
+  {
+    index = static_cast<uint32_t>(this->slots.size());
+    this->slots.emplace_back();
+  }
+  else
+  {
+    index = this->free_slots.back();
+    this->free_slots.pop_back();
+  }
+
+  NodeSlot &slot = this->slots[index];
+  slot.p_node = p_node.get();
+  slot.id = node_id;
+
+  p_node->set_handle(NodeHandle{index, slot.generation});
+
+  // an isolated node can be appended to a valid topological order
+  slot.rank = this->next_rank++;
+  this->topology_version++;
+
+  if (!this->is_topology_dirty)
+  {
+    slot.order_pos = static_cast<uint32_t>(this->topological_slots.size());
+    this->topological_order.push_back(node_id);
+    this->topological_slots.push_back(index);
+  }
+
   // keep track of the parent graph
   p_node->set_p_graph(this);
 
   return node_id;
 }
 
+void Graph::cancel_update()
+{
+  std::lock_guard<std::mutex> lock(this->async_mutex);
+  if (this->async_token) this->async_token->cancel();
+}
+
 void Graph::clear()
 {
+  for (auto &[_, p_node] : this->nodes)
+  {
+    this->discard_evicted_outputs(p_node.get());
+    helper_unbind_inputs(*p_node);
+    p_node->set_handle(NodeHandle());
+  }
+
   this->nodes.clear();
   this->links.clear();
+  this->link_table.clear();
+  this->link_rows.clear();
+  // the slots are released rather than dropped, so that the handles obtained
+  // before are not taken for those of the next nodes (lowest indices reused
+  // first)
+  this->free_slots.clear();
+
+  for (uint32_t index = static_cast<uint32_t>(this->slots.size()); index-- > 0;)
+  {
+    const uint32_t generation = this->slots[index].generation;
+
+    this->slots[index] = NodeSlot();
+    this->slots[index].generation = generation + 1;
+    this->free_slots.push_back(index);
+  }
+
+  this->topological_order.clear();
+  this->topological_slots.clear();
+  this->topological_removed = 0;
+  this->next_rank = 0;
+  this->is_topology_dirty = false;
+  this->topology_version++;
   this->id_count = 0;
 }
 
+const ExecutionPlan &Graph::compile()
+{
+  // the topological order is only recomputed after a structural change
+  this->get_topological_order();
+
+  auto         p_plan = std::make_unique<ExecutionPlan>();
+  const size_t n = this->topological_slots.size();
+
+  p_plan->slots = this->topological_slots;
+  p_plan->nodes.reserve(n);
+  p_plan->topology_version = this->topology_version;
+
+  for (size_t k = 0; k < n; ++k)
+  {
+    NodeSlot &slot = this->slots[p_plan->slots[k]];
+
+    slot.task = static_cast<uint32_t>(k);
+    p_plan->nodes.push_back(slot.p_node);
+  }
+
+  // --- dependencies, priorities from the cost estimates at compile time
+
+  TaskGraph &tasks = p_plan->tasks;
+
+  tasks.in_degree.resize(n, 0);
+  tasks.priority.resize(n, 0.0);
+  tasks.successor_offsets.reserve(n + 1);
+  tasks.successor_offsets.push_back(0);
+
+  for (size_t k = 0; k < n; ++k)
+  {
+    for (const auto &edge : this->slots[p_plan->slots[k]].downstream)
+    {
+      const uint32_t next = this->slots[edge.node.index].task;
+
+      tasks.successors.push_back(next);
+      tasks.in_degree[next]++;
+    }
+
+    tasks.successor_offsets.push_back(
+        static_cast<uint32_t>(tasks.successors.size()));
+  }
+
+  for (size_t k = n; k-- > 0;)
+  {
+    double longest = 0.0;
+
+    for (uint32_t s = tasks.successor_offsets[k];
+         s < tasks.successor_offsets[k + 1];
+         ++s)
+      longest = std::max(longest, tasks.priority[tasks.successors[s]]);
+
+    tasks.priority[k] = this->get_slot_cost(p_plan->slots[k]) + longest;
+  }
+
+  this->plan = std::move(p_plan);
+  return *this->plan;
+}
+
+void Graph::compact_links()
+{
+  if (this->link_table.get_erased_count() == 0) return;
+
+  // the remaining rows are renumbered in order
+  this->drop_removed_links();
+  this->link_table.compact();
+  std::iota(this->link_rows.begin(), this->link_rows.end(), size_t(0));
+}
+
+void Graph::drop_removed_links() const
+{
+  if (this->links.size() ==
+      this->link_table.size() - this->link_table.get_erased_count())
+    return;
+
+  size_t kept = 0;
+
+  for (size_t k = 0; k < this->links.size(); ++k)
+  {
+    if (!this->link_table.is_alive(this->link_rows[k])) continue;
+
+    if (kept != k)
+    {
+      this->links[kept] = std::move(this->links[k]);
+      this->link_rows[kept] = this->link_rows[k];
+    }
+    kept++;
+  }
+
+  this->links.erase(this->links.begin() + kept, this->links.end());
+  this->link_rows.resize(kept);
+}
+
 std::vector<Point> Graph::compute_graph_layout_sugiyama()
 {
   std::vector<Point> points;
@@ -73,21 +304,20 @@ std::vector<Point> Graph::compute_graph_layout_sugiyama()
   // Create an adjacency list for the Sugiyama procedure
   std::vector<std::vector<size_t>> adj(num_nodes);
 
-  // Build a node ID to node index map
-  std::map<std::string, size_t> node_idx;
-  size_t                        idx = 0;
+  // Build a node slot to node index map
+  std::vector<size_t> node_idx(this->slots.size());
+  size_t              idx = 0;
 
   for (const auto &[nid, p_node] : this->nodes)
-    node_idx[nid] = idx++;
+    node_idx[p_node->get_handle().index] = idx++;
 
   // Populate the adjacency list using downstream connectivity
-  const auto connectivity = this->get_connectivity_downstream();
-
-  for (const auto &[nid, to_ids] : connectivity)
+  for (const auto &[nid, p_node] : this->nodes)
   {
-    size_t from_idx = node_idx.at(nid);
-    for (const auto &to_id : to_ids)
-      adj[from_idx].push_back(node_idx.at(to_id));
+    const uint32_t index = p_node->get_handle().index;
+
+    for (const auto &edge : this->slots[index].downstream)
+      adj[node_idx[index]].push_back(node_idx[edge.node.index]);
   }
 
   // Build the graph using the adjacency list
@@ -133,288 +363,1331 @@ std::vector<Point> Graph::compute_graph_layout_sugiyama()
   return points;
 }
 
-void Graph::export_to_graphviz(const std::string &fname,
-                               const std::string &graph_label)
+void Graph::discard_evicted_outputs(Node *p_node)
 {
-  std::ofstream file(fname);
-
-  if (!file.is_open())
-    throw std::runtime_error("Failed to open file: " + fname);
-
-  file << "digraph root {\n";
-  file << "label=\"" << graph_label << "\";\n";
-  file << "labelloc=\"t\";\n";
-  file << "rankdir=TD;\n";
-  file << "ranksep=0.5;\n";
-  file << "node [shape=record];\n";
-
-  // Output nodes with their labels
-  for (const auto &[id, p_node] : this->nodes)
-    file << id << " [label=\"" << p_node->get_label() << "\"];\n";
-
-  // Output edges
-  const auto connectivity = this->get_connectivity_downstream();
+  for (const auto &port : p_node->get_ports())
+  {
+    if (port->get_port_type() != PortType::OUT) continue;
 
-  for (const auto &[from_id, to_ids] : connectivity)
-    for (const auto &to_id : to_ids)
-      file << from_id << " -> " << to_id << ";\n";
+    std::shared_ptr<BaseData> p_data = port->get_data_shared_ptr_downcasted();
 
-  file << "}\n";
+    if (p_data && p_data->get_residency() != DataResidency::RESIDENT)
+      p_data->set_resident();
+  }
 }
 
-void Graph::export_to_mermaid(const std::string &fname,
-                              const std::string &graph_label)
+void Graph::enforce_memory_budget()
 {
-  std::fstream f;
-  f.open(fname, std::ios::out);
-
-  f << "---" << std::endl;
-  f << "title: " << graph_label << std::endl;
-  f << "---" << std::endl;
-  f << "flowchart LR" << std::endl;
+  if (this->memory_budget == 0) return;
 
-  // nodes
-  for (const auto &[id, p_node] : this->nodes)
-    f << "    " << id << "([" << p_node->get_label() << "])\n";
+  size_t usage = this->get_memory_usage();
+  if (usage <= this->memory_budget) return;
 
-  // Output edges
-  const auto connectivity = this->get_connectivity_downstream();
+  // intermediate outputs, least recently used first
+  std::vector<uint32_t> candidates;
 
-  for (const auto &[from_id, to_ids] : connectivity)
-    for (const auto &to_id : to_ids)
-      f << from_id << " --> " << to_id << ";\n";
+  for (uint32_t index = 0; index < this->slots.size(); ++index)
+  {
+    const NodeSlot &slot = this->slots[index];
 
-  f.close();
-}
+    if (slot.p_node && !slot.downstream.empty() && !slot.p_node->is_dirty)
+      candidates.push_back(index);
+  }
 
-std::map<std::string, std::vector<std::string>> Graph::
-    get_connectivity_downstream() const
-{
-  std::map<std::string, std::vector<std::string>> connectivity;
+  std::sort(candidates.begin(),
+            candidates.end(),
+            [this](uint32_t a, uint32_t b)
+            { return this->slots[a].last_use < this->slots[b].last_use; });
 
-  // to get all the nodes in the mapping, even if they have no node
-  // downstream
-  for (const auto &[nid, _] : this->nodes)
-    connectivity[nid] = {};
+  for (uint32_t index : candidates)
+  {
+    if (usage <= this->memory_budget) break;
 
-  for (const auto &link : this->links)
-    connectivity[link.from].push_back(link.to);
+    usage -= std::min(usage, this->evict_outputs(index, this->eviction_mode));
+  }
 
-  return connectivity;
+  Logger::log()->trace("Graph::enforce_memory_budget: usage {} / {} bytes",
+                       usage,
+                       this->memory_budget);
 }
 
-std::vector<std::string> Graph::get_connectivity_downstream(
-    const std::string &node_id) const
+void Graph::erase_link(size_t row)
 {
-  std::vector<std::string> connectivity = {};
+  const uint32_t from = this->link_table.from[row];
+  const uint32_t to = this->link_table.to[row];
 
-  for (const auto &link : this->links)
+  // swap-and-pop the edge from both adjacency lists, the position of the
+  // moved edge being updated through its link row
+  std::vector<Edge> &dw = this->slots[from].downstream;
+  const uint32_t     pos_dw = this->link_table.pos_downstream[row];
+
+  if (pos_dw + 1 != dw.size())
   {
-    if (link.from == node_id) connectivity.push_back(link.to);
+    dw[pos_dw] = dw.back();
+
+    const Edge &edge = dw[pos_dw];
+    size_t      moved = this->link_table.find(from,
+                                              edge.port_from,
+                                              edge.node.index,
+                                              edge.port_to);
+    this->link_table.pos_downstream[moved] = pos_dw;
   }
+  dw.pop_back();
 
-  return connectivity;
-}
-
-std::map<std::string, std::vector<std::string>> Graph::
-    get_connectivity_upstream() const
-{
-  std::map<std::string, std::vector<std::string>> connectivity;
+  std::vector<Edge> &up = this->slots[to].upstream;
+  const uint32_t     pos_up = this->link_table.pos_upstream[row];
 
-  // to get all the nodes in the mapping, even if they have no node
-  // upstream
-  for (const auto &[nid, _] : this->nodes)
-    connectivity[nid] = {};
+  if (pos_up + 1 != up.size())
+  {
+    up[pos_up] = up.back();
+
+    const Edge &edge = up[pos_up];
+    size_t      moved = this->link_table.find(edge.node.index,
+                                              edge.port_from,
+                                              to,
+                                              edge.port_to);
+    this->link_table.pos_upstream[moved] = pos_up;
+  }
+  up.pop_back();
 
-  for (const auto &link : this->links)
-    connectivity[link.to].push_back(link.from);
+  this->slots[to].is_forced = true;
+  this->topology_version++;
 
-  return connectivity;
+  // the rows are compacted lazily, see compact_links
+  this->link_table.erase(row);
 }
 
-std::vector<std::string> Graph::get_connectivity_upstream(
-    const std::string &node_id) const
+size_t Graph::evict_outputs(uint32_t index, EvictionMode mode)
 {
-  std::vector<std::string> connectivity = {};
+  Node      *p_node = this->slots[index].p_node;
+  NodeHandle handle = p_node->get_handle();
+  size_t     released = 0;
 
-  for (const auto &link : this->links)
+  auto hook = [this, handle]() { this->restore_outputs(handle); };
+
+  for (const auto &port : p_node->get_ports())
   {
-    if (link.to == node_id) connectivity.push_back(link.from);
-  }
+    if (port->get_port_type() != PortType::OUT) continue;
 
-  return connectivity;
-}
+    std::shared_ptr<BaseData> p_data = port->get_data_shared_ptr_downcasted();
 
-std::vector<LinkView> Graph::get_link_views(const std::string &node_id) const
-{
-  std::vector<gnode::LinkView> link_views = {};
+    if (!p_data || p_data->is_pinned() ||
+        p_data->get_residency() != DataResidency::RESIDENT)
+      continue;
 
-  for (const auto &link : this->get_links())
-  {
-    if (link.from == node_id || link.to == node_id)
-    {
-      Node *p_from = this->get_node_ref_by_id(link.from);
-      Node *p_to = this->get_node_ref_by_id(link.to);
+    const size_t bytes = p_data->get_byte_size();
+    bool         is_evicted = false;
 
-      if (!p_from || !p_to) continue;
+    if (mode == EvictionMode::SPILL)
+    {
+      if (this->spill_directory.empty())
+      {
+        std::random_device rd;
+        this->spill_directory = std::filesystem::temp_directory_path() /
+                                ("gnode_spill_" + std::to_string(rd()));
+        std::filesystem::create_directories(this->spill_directory);
+      }
 
-      LinkView data(link, *p_from, *p_to);
-      link_views.push_back(data);
+      is_evicted = p_data->spill(
+          this->spill_directory /
+              (std::to_string(this->spill_count++) + ".spill"),
+          hook);
     }
+
+    // data that cannot be serialized is dropped
+    if (!is_evicted) is_evicted = p_data->drop(hook);
+
+    if (is_evicted)
+      released += bytes - std::min(bytes, p_data->get_byte_size());
   }
 
-  return link_views;
+  return released;
 }
 
-std::vector<std::string> Graph::get_nodes_to_update(
-    const std::vector<std::string> &node_ids)
+void Graph::evaluate(const std::vector<std::string> &node_ids)
 {
-  // --- validate input nodes
+  std::vector<uint32_t> sinks;
+  sinks.reserve(node_ids.size());
 
   for (const auto &node_id : node_ids)
   {
-    if (this->is_node_id_available(node_id))
+    NodeHandle handle = this->get_node_handle(node_id);
+
+    if (!this->is_handle_valid(handle))
     {
-      Logger::log()->trace("Graph::update: unknown node id {}", node_id);
-      return {};
+      Logger::log()->trace("Graph::evaluate: unknown node id {}", node_id);
+      return;
     }
+
+    sinks.push_back(handle.index);
   }
 
-  // --- check upstream dependencies
+  // --- upstream cones of the requested nodes, in topological order
 
-  auto connectivity_up = this->get_connectivity_upstream();
+  uint32_t              epoch = this->new_mark_epoch();
+  std::vector<uint32_t> sorted_slots = this->topological_sort_slots(
+      this->mark_upstream(sinks, epoch),
+      epoch);
 
-  for (const auto &node_id : node_ids)
+  // --- nodes to compute, dirty or depending on a node to compute (the
+  // --- cones being closed upstream, no membership check is needed)
+
+  epoch = this->new_mark_epoch();
+
+  std::vector<uint32_t> needed_slots;
+
+  for (uint32_t index : sorted_slots)
   {
-    for (const auto &id_up : connectivity_up[node_id])
-    {
-      Node *p_node = this->get_node_ref_by_id(id_up);
+    NodeSlot &slot = this->slots[index];
+    bool      is_needed = slot.p_node->is_dirty;
 
-      if (p_node && p_node->is_dirty)
-      {
-        Logger::log()->trace("Graph::update: no update of the graph");
-        return {};
-      }
+    for (const auto &edge : slot.upstream)
+      if (this->slots[edge.node.index].mark == epoch) is_needed = true;
+
+    if (is_needed)
+    {
+      slot.mark = epoch;
+      needed_slots.push_back(index);
     }
   }
 
-  // --- collect downstream dirty nodes
+  if (needed_slots.empty()) return;
 
-  std::vector<std::string> dirty_node_ids = {};
+  // --- everything downstream of the computed nodes is outdated, the nodes
+  // --- outside of the cones being left dirty (and not to be cut off, their
+  // --- inputs being updated now)
 
-  auto connectivity_dw = this->get_connectivity_downstream();
+  epoch = this->new_mark_epoch();
 
-  for (const auto &node_id : node_ids)
-    helper_mark_dirty(node_id, dirty_node_ids, connectivity_dw);
+  for (uint32_t index : needed_slots)
+    this->slots[index].mark = epoch;
 
-  // --- remove duplicates
+  std::vector<uint32_t> stale_slots;
 
-  std::sort(dirty_node_ids.begin(), dirty_node_ids.end());
+  for (uint32_t index : needed_slots)
+    for (const auto &edge : this->slots[index].downstream)
+      if (this->slots[edge.node.index].mark != epoch)
+        stale_slots.push_back(edge.node.index);
 
-  dirty_node_ids.erase(
-      std::unique(dirty_node_ids.begin(), dirty_node_ids.end()),
-      dirty_node_ids.end());
+  for (uint32_t index : this->mark_downstream(stale_slots, epoch))
+  {
+    NodeSlot &slot = this->slots[index];
+
+    if (!slot.p_node->is_dirty)
+    {
+      slot.p_node->is_dirty = true;
+      slot.is_forced = true;
+    }
+  }
 
-  // --- topological ordering
+  for (uint32_t index : needed_slots)
+    this->slots[index].p_node->is_dirty = true;
 
-  return topological_sort(dirty_node_ids);
-}
+  // --- update
 
-std::vector<std::string> Graph::get_nodes_to_update(const std::string &node_id)
-{
-  return this->get_nodes_to_update(std::vector<std::string>{node_id});
-}
+  epoch = this->new_mark_epoch();
 
-bool Graph::has_cycle() const
-{
-  std::vector<std::string> all_nodes;
+  std::vector<std::string> sorted_id;
+  sorted_id.reserve(needed_slots.size());
 
-  for (const auto &[id, _] : nodes)
-    all_nodes.push_back(id);
+  for (uint32_t index : needed_slots)
+  {
+    this->slots[index].mark = epoch;
+    sorted_id.push_back(this->slots[index].id);
+  }
 
-  auto sorted = topological_sort(all_nodes);
+  this->update_slots(needed_slots, sorted_id, epoch);
 
-  return sorted.size() != all_nodes.size();
+  this->post_update();
 }
 
-bool Graph::is_node_id_available(const std::string &node_id)
+void Graph::evaluate(const std::string &node_id, const std::string &port_label)
 {
-  return !this->nodes.contains(node_id);
-}
+  if (this->is_node_id_available(node_id))
+    throw std::runtime_error("Unknown node ID: " + node_id);
 
-bool Graph::is_reachable(const std::string              &start,
-                         const std::string              &target,
-                         std::unordered_set<std::string> visited) const
-{
-  if (start == target) return true;
-  if (visited.count(start)) return false;
-  visited.insert(start);
+  Node *p_node = this->nodes.at(node_id).get();
 
-  for (const auto &link : this->links)
+  if (p_node->get_port_type(port_label) == PortType::OUT)
   {
-    if (link.from == start)
-    {
-      if (is_reachable(link.to, target, visited)) return true;
-    }
+    this->evaluate(std::vector<std::string>{node_id});
+    return;
   }
-  return false;
+
+  // input port, only the node feeding the port is evaluated
+  const Link *p_link = this->get_input_link(node_id,
+                                            p_node->get_port_index(port_label));
+
+  if (p_link) this->evaluate(std::vector<std::string>{p_link->from});
 }
 
-// connect two nodes, note that data types are not verified
-bool Graph::new_link(const std::string &from,
-                     int                port_from,
-                     const std::string &to,
-                     int                port_to)
+BatchResult Graph::evaluate_batch(const ParameterTable           &table,
+                                  const std::vector<std::string> &node_ids)
 {
-  Link new_link(from, port_from, to, port_to);
+  const auto &columns = table.get_columns();
+  BatchResult result(table.get_variant_count());
 
-  // Check if the link already exists
-  if (std::find(this->links.begin(), this->links.end(), new_link) !=
-      this->links.end())
-    return false;
+  // --- overridden ports, checked before anything is computed
 
-  // Get the output data from the source node
-  auto from_node_it = this->nodes.find(from);
-  if (from_node_it == this->nodes.end())
-    throw std::runtime_error("Source node not found: " + from);
+  std::vector<std::shared_ptr<BaseData>> targets;
+  std::vector<std::shared_ptr<BaseData>> originals;
+  std::vector<uint32_t>                  roots;
 
-  auto to_node_it = this->nodes.find(to);
-  if (to_node_it == this->nodes.end())
-    throw std::runtime_error("Destination node not found: " + to);
+  for (const auto &column : columns)
+  {
+    if (this->is_node_id_available(column.node_id))
+      throw std::runtime_error("Unknown node ID: " + column.node_id);
 
-  std::shared_ptr<BaseData> from_data = from_node_it->second->get_output_data(
-      port_from);
+    Node     *p_node = this->nodes.at(column.node_id).get();
+    const int port_index = p_node->get_port_index(column.port_label);
 
-  // Set the input data on the destination node
-  to_node_it->second->set_input_data(from_data, port_to);
+    if (port_index < 0 ||
+        p_node->get_port_type(column.port_label) != PortType::OUT)
+      throw std::runtime_error("evaluate_batch: output port not found: " +
+                               column.node_id + ", " + column.port_label);
 
-  // Add the new link to the list of links
-  this->links.push_back(new_link);
+    std::shared_ptr<BaseData> p_target = p_node->get_output_data(port_index);
 
-  return true;
-}
+    for (const auto &p_value : column.values)
+      if (p_value && !p_value->is_same_type(*p_target))
+        throw std::runtime_error("evaluate_batch: type mismatch: " +
+                                 column.node_id + ", " + column.port_label);
 
-bool Graph::new_link(const std::string &from,
-                     const std::string &port_label_from,
-                     const std::string &to,
-                     const std::string &port_label_to)
-{
-  // Check that the 'from' port is an output port
-  if (this->nodes.at(from)->get_port_type(port_label_from) != PortType::OUT)
-    throw std::invalid_argument("Port '" + port_label_from + "' on node '" +
-                                from + "' must be an output port.");
+    targets.push_back(p_target);
+    originals.push_back(p_target->clone());
+    roots.push_back(p_node->get_handle().index);
+  }
 
-  // Check that the 'to' port is an input port
-  if (this->nodes.at(to)->get_port_type(port_label_to) != PortType::IN)
-    throw std::invalid_argument("Port '" + port_label_to + "' on node '" + to +
-                                "' must be an input port.");
+  std::vector<uint32_t> sinks;
+  sinks.reserve(node_ids.size());
 
-  // Call the existing connect method using the port indices
-  return this->new_link(from,
-                        this->nodes.at(from)->get_port_index(port_label_from),
-                        to,
-                        this->nodes.at(to)->get_port_index(port_label_to));
-}
+  for (const auto &node_id : node_ids)
+  {
+    if (this->is_node_id_available(node_id))
+      throw std::runtime_error("Unknown node ID: " + node_id);
+
+    sinks.push_back(this->nodes.at(node_id)->get_handle().index);
+  }
+
+  // --- requested nodes up to date with the graph values
+
+  this->evaluate(node_ids);
+
+  // --- nodes to compute for each variant, sorted once: upstream of the
+  // --- requested nodes and downstream of the overridden nodes
+
+  std::vector<char> is_upstream(this->slots.size(), 0);
+
+  for (uint32_t index : this->mark_upstream(sinks, this->new_mark_epoch()))
+    is_upstream[index] = 1;
+
+  for (uint32_t index : roots)
+    is_upstream[index] = 0;
+
+  uint32_t              epoch = this->new_mark_epoch();
+  std::vector<uint32_t> plan;
+
+  for (uint32_t index : this->mark_downstream(roots, epoch))
+    if (is_upstream[index]) plan.push_back(index);
+
+  epoch = this->new_mark_epoch();
+
+  for (uint32_t index : plan)
+    this->slots[index].mark = epoch;
+
+  plan = this->topological_sort_slots(plan, epoch);
+
+  std::vector<std::string> sorted_ids;
+  sorted_ids.reserve(plan.size());
+
+  for (uint32_t index : plan)
+    sorted_ids.push_back(this->slots[index].id);
+
+  // --- data of each variant, side by side: overridden ports, and outputs of
+  // --- the nodes to compute, allocated upfront
+
+  const size_t variant_count = table.get_variant_count();
+
+  // task of each slot, the marks being possibly changed by the restore hooks
+  // of the data read during the evaluation
+  constexpr uint32_t    no_task = std::numeric_limits<uint32_t>::max();
+  std::vector<uint32_t> task_of(this->slots.size(), no_task);
+
+  std::vector<VariantBatch> batches(plan.size());
+  bool                      is_batched = true;
+
+  for (size_t k = 0; k < plan.size() && is_batched; ++k)
+  {
+    Node *p_node = this->slots[plan[k]].p_node;
+
+    task_of[plan[k]] = static_cast<uint32_t>(k);
+    batches[k] = VariantBatch(variant_count, p_node->get_nports());
+
+    for (int i = 0; i < p_node->get_nports() && is_batched; ++i)
+    {
+      if (p_node->get_ports()[i]->get_port_type() != PortType::OUT) continue;
+
+      std::shared_ptr<BaseData>              p_data = p_node->get_output_data(i);
+      std::vector<std::shared_ptr<BaseData>> variants(variant_count);
+
+      for (auto &p_variant : variants)
+        if (!(p_variant = p_data->clone())) is_batched = false;
+
+      batches[k].set_variants(i, std::move(variants));
+    }
+  }
+
+  // output data of each variant, the data of the graph for the ports
+  // depending on no override
+  auto get_variants = [&](uint32_t index, int port_index)
+  {
+    if (task_of[index] != no_task)
+      return batches[task_of[index]].get_variants(port_index);
+
+    std::vector<std::shared_ptr<BaseData>> variants(
+        variant_count,
+        this->slots[index].p_node->get_output_data(port_index));
+
+    for (size_t c = 0; c < columns.size(); ++c)
+      if (roots[c] == index && targets[c] == variants.front())
+        for (size_t variant = 0; variant < variant_count; ++variant)
+          if (variant < columns[c].values.size() && columns[c].values[variant])
+            variants[variant] = columns[c].values[variant];
+
+    return variants;
+  };
+
+  if (is_batched)
+  {
+    // --- single pass over the nodes for all the variants, the nodes being
+    // --- run as tasks (dependencies within the plan)
+
+    TaskGraph tasks;
+
+    tasks.in_degree.resize(plan.size(), 0);
+    tasks.successor_offsets.reserve(plan.size() + 1);
+    tasks.successor_offsets.push_back(0);
+
+    for (uint32_t index : plan)
+    {
+      for (const auto &edge : this->slots[index].downstream)
+      {
+        const uint32_t next = task_of[edge.node.index];
+        if (next == no_task) continue;
+
+        tasks.successors.push_back(next);
+        tasks.in_degree[next]++;
+      }
+
+      tasks.successor_offsets.push_back(
+          static_cast<uint32_t>(tasks.successors.size()));
+    }
+
+    auto run_task = [&](uint32_t k)
+    {
+      const uint32_t index = plan[k];
+      Node          *p_node = this->slots[index].p_node;
+
+      for (int i = 0; i < p_node->get_nports(); ++i)
+      {
+        if (p_node->get_ports()[i]->get_port_type() != PortType::IN) continue;
+
+        const size_t row = this->link_table.find_input(index, i);
+
+        if (row != LinkTable::npos)
+          batches[k].set_variants(i,
+                                  get_variants(this->link_table.from[row],
+                                               this->link_table.port_from[row]));
+      }
+
+      p_node->update_variants(batches[k]);
+    };
+
+    SerialExecutor serial_executor;
+    Executor      &executor = this->deterministic ? serial_executor
+                                                  : *this->executor;
+
+    // inputs bound to variant data are not to be taken over
+    this->is_evaluating_variants = true;
+
+    try
+    {
+      executor.run(tasks, run_task);
+    }
+    catch (...)
+    {
+      this->is_evaluating_variants = false;
+      this->flag_dirty(plan, {});
+      throw;
+    }
+
+    this->is_evaluating_variants = false;
+    this->flag_dirty(plan, {});
+
+    for (const auto &node_id : node_ids)
+    {
+      Node          *p_node = this->nodes.at(node_id).get();
+      const uint32_t index = p_node->get_handle().index;
+      const bool     is_computed = task_of[index] != no_task;
+
+      for (int k = 0; k < p_node->get_nports(); ++k)
+      {
+        if (p_node->get_ports()[k]->get_port_type() != PortType::OUT) continue;
+
+        std::vector<std::shared_ptr<BaseData>> variants = get_variants(index,
+                                                                       k);
+
+        for (size_t variant = 0; variant < variant_count; ++variant)
+          result.set_base_data(variant,
+                               node_id,
+                               p_node->get_port_label(k),
+                               is_computed ? variants[variant]
+                                           : variants[variant]->clone());
+      }
+    }
+
+    this->post_update();
+    return result;
+  }
+
+  // --- serial evaluation, one update of the nodes per variant
+
+  auto set_results = [&](size_t variant)
+  {
+    for (const auto &node_id : node_ids)
+    {
+      Node *p_node = this->nodes.at(node_id).get();
+
+      for (int k = 0; k < p_node->get_nports(); ++k)
+        if (p_node->get_ports()[k]->get_port_type() == PortType::OUT)
+          result.set_base_data(variant,
+                               node_id,
+                               p_node->get_port_label(k),
+                               p_node->get_output_data(k)->clone());
+    }
+  };
+
+  auto set_values = [&](size_t variant)
+  {
+    for (size_t c = 0; c < targets.size(); ++c)
+    {
+      const BaseData *p_source = variant < columns[c].values.size() &&
+                                         columns[c].values[variant]
+                                     ? columns[c].values[variant].get()
+                                     : originals[c].get();
+
+      if (p_source && !targets[c]->copy_from(*p_source))
+        throw std::runtime_error("evaluate_batch: value cannot be copied: " +
+                                 columns[c].node_id + ", " +
+                                 columns[c].port_label);
+    }
+  };
+
+  // graph values brought back, the nodes computed with the variants being
+  // outdated
+  auto restore = [&]()
+  {
+    set_values(variant_count);
+    this->flag_dirty(plan, {});
+  };
+
+  try
+  {
+    for (size_t variant = 0; variant < variant_count; ++variant)
+    {
+      set_values(variant);
+
+      // the marks may have been changed by the restore hooks of the
+      // previous variant
+      epoch = this->new_mark_epoch();
+
+      for (uint32_t index : plan)
+        this->slots[index].mark = epoch;
+
+      this->flag_dirty(plan, {});
+      this->update_slots(plan, sorted_ids, epoch);
+      set_results(variant);
+    }
+  }
+  catch (...)
+  {
+    restore();
+    throw;
+  }
+
+  restore();
+  this->post_update();
+
+  return result;
+}
+
+void Graph::export_to_graphviz(const std::string &fname,
+                               const std::string &graph_label)
+{
+  std::ofstream file(fname);
+
+  if (!file.is_open())
+    throw std::runtime_error("Failed to open file: " + fname);
+
+  file << "digraph root {\n";
+  file << "label=\"" << graph_label << "\";\n";
+  file << "labelloc=\"t\";\n";
+  file << "rankdir=TD;\n";
+  file << "ranksep=0.5;\n";
+  file << "node [shape=record];\n";
+
+  // Output nodes with their labels
+  for (const auto &[id, p_node] : this->nodes)
+    file << id << " [label=\"" << p_node->get_label() << "\"];\n";
+
+  // Output edges
+  for (const auto &[from_id, p_node] : this->nodes)
+    for (const auto &edge : this->get_edges_downstream(p_node->get_handle()))
+      file << from_id << " -> " << this->get_node_id(edge.node) << ";\n";
+
+  file << "}\n";
+}
+
+void Graph::export_to_mermaid(const std::string &fname,
+                              const std::string &graph_label)
+{
+  std::fstream f;
+  f.open(fname, std::ios::out);
+
+  f << "---" << std::endl;
+  f << "title: " << graph_label << std::endl;
+  f << "---" << std::endl;
+  f << "flowchart LR" << std::endl;
+
+  // nodes
+  for (const auto &[id, p_node] : this->nodes)
+    f << "    " << id << "([" << p_node->get_label() << "])\n";
+
+  // Output edges
+  for (const auto &[from_id, p_node] : this->nodes)
+    for (const auto &edge : this->get_edges_downstream(p_node->get_handle()))
+      f << from_id << " --> " << this->get_node_id(edge.node) << ";\n";
+
+  f.close();
+}
+
+std::map<std::string, std::vector<std::string>> Graph::
+    get_connectivity_downstream() const
+{
+  std::map<std::string, std::vector<std::string>> connectivity;
+
+  // to get all the nodes in the mapping, even if they have no node
+  // downstream
+  for (const auto &[nid, _] : this->nodes)
+    connectivity[nid] = this->get_connectivity_downstream(nid);
+
+  return connectivity;
+}
+
+std::vector<std::string> Graph::get_connectivity_downstream(
+    const std::string &node_id) const
+{
+  const auto &edges = this->get_edges_downstream(
+      this->get_node_handle(node_id));
+
+  std::vector<std::string> connectivity;
+  connectivity.reserve(edges.size());
+
+  for (const auto &edge : edges)
+    connectivity.push_back(this->get_node_id(edge.node));
+
+  return connectivity;
+}
+
+std::map<std::string, std::vector<std::string>> Graph::
+    get_connectivity_upstream() const
+{
+  std::map<std::string, std::vector<std::string>> connectivity;
+
+  // to get all the nodes in the mapping, even if they have no node
+  // upstream
+  for (const auto &[nid, _] : this->nodes)
+    connectivity[nid] = this->get_connectivity_upstream(nid);
+
+  return connectivity;
+}
+
+std::vector<std::string> Graph::get_connectivity_upstream(
+    const std::string &node_id) const
+{
+  const auto &edges = this->get_edges_upstream(this->get_node_handle(node_id));
+
+  std::vector<std::string> connectivity;
+  connectivity.reserve(edges.size());
+
+  for (const auto &edge : edges)
+    connectivity.push_back(this->get_node_id(edge.node));
+
+  return connectivity;
+}
+
+const std::vector<Edge> &Graph::get_edges_downstream(NodeHandle handle) const
+{
+  static const std::vector<Edge> no_edges = {};
+
+  if (!this->is_handle_valid(handle)) return no_edges;
+  return this->slots[handle.index].downstream;
+}
+
+const std::vector<Edge> &Graph::get_edges_upstream(NodeHandle handle) const
+{
+  static const std::vector<Edge> no_edges = {};
+
+  if (!this->is_handle_valid(handle)) return no_edges;
+  return this->slots[handle.index].upstream;
+}
+
+void Graph::flag_dirty(const std::vector<uint32_t> &cone,
+                       const std::vector<uint32_t> &roots)
+{
+  for (uint32_t index : cone)
+  {
+    NodeSlot &slot = this->slots[index];
+
+    // the reason why a node is already dirty is unknown
+    if (slot.p_node->is_dirty)
+      slot.is_forced = true;
+    else
+      slot.p_node->is_dirty = true;
+  }
+
+  for (uint32_t index : roots)
+  {
+    this->slots[index].is_forced = true;
+    this->slots[index].p_node->is_dirty = true;
+  }
+}
+
+bool Graph::flush_updates()
+{
+  std::vector<std::string> node_ids;
+
+  {
+    std::lock_guard<std::mutex> lock(this->pending_mutex);
+    node_ids.swap(this->pending_ids);
+  }
+
+  // nodes removed since their request are dropped
+  std::erase_if(node_ids,
+                [this](const std::string &node_id)
+                { return this->is_node_id_available(node_id); });
+
+  if (node_ids.empty()) return false;
+
+  this->update(node_ids);
+  return true;
+}
+
+const Link *Graph::get_input_link(const std::string &node_id,
+                                  int                port_index) const
+{
+  const NodeHandle handle = this->get_node_handle(node_id);
+  if (!this->is_handle_valid(handle)) return nullptr;
+
+  size_t row = this->link_table.find_input(handle.index, port_index);
+  return row == LinkTable::npos ? nullptr
+                                : &this->links[this->get_link_position(row)];
+}
+
+const std::vector<Link> &Graph::get_links() const
+{
+  this->drop_removed_links();
+  return this->links;
+}
+
+size_t Graph::get_link_position(size_t row) const
+{
+  return std::lower_bound(this->link_rows.begin(), this->link_rows.end(), row) -
+         this->link_rows.begin();
+}
+
+std::vector<LinkView> Graph::get_link_views(const std::string &node_id) const
+{
+  std::vector<gnode::LinkView> link_views = {};
+
+  const NodeHandle handle = this->get_node_handle(node_id);
+  if (!this->is_handle_valid(handle)) return link_views;
+
+  const NodeSlot &slot = this->slots[handle.index];
+
+  link_views.reserve(slot.downstream.size() + slot.upstream.size());
+
+  for (const auto &edge : slot.downstream)
+  {
+    const NodeSlot &other = this->slots[edge.node.index];
+    Link            link(node_id, edge.port_from, other.id, edge.port_to);
+
+    link_views.emplace_back(link, *slot.p_node, *other.p_node);
+  }
+
+  for (const auto &edge : slot.upstream)
+  {
+    const NodeSlot &other = this->slots[edge.node.index];
+    Link            link(other.id, edge.port_from, node_id, edge.port_to);
+
+    link_views.emplace_back(link, *other.p_node, *slot.p_node);
+  }
+
+  return link_views;
+}
+
+std::vector<Link> Graph::get_links_downstream(const std::string &node_id) const
+{
+  const auto &edges = this->get_edges_downstream(
+      this->get_node_handle(node_id));
+
+  std::vector<Link> links_dw;
+  links_dw.reserve(edges.size());
+
+  for (const auto &edge : edges)
+    links_dw.emplace_back(node_id,
+                          edge.port_from,
+                          this->get_node_id(edge.node),
+                          edge.port_to);
+
+  return links_dw;
+}
+
+std::vector<Link> Graph::get_links_upstream(const std::string &node_id) const
+{
+  const auto &edges = this->get_edges_upstream(this->get_node_handle(node_id));
+
+  std::vector<Link> links_up;
+  links_up.reserve(edges.size());
+
+  for (const auto &edge : edges)
+    links_up.emplace_back(this->get_node_id(edge.node),
+                          edge.port_from,
+                          node_id,
+                          edge.port_to);
+
+  return links_up;
+}
+
+size_t Graph::get_memory_usage() const
+{
+  size_t usage = 0;
+
+  for (const auto &[_, p_node] : this->nodes)
+    for (const auto &port : p_node->get_ports())
+    {
+      if (port->get_port_type() != PortType::OUT) continue;
+
+      std::shared_ptr<BaseData> p_data = port->get_data_shared_ptr_downcasted();
+
+      if (p_data && p_data->get_residency() == DataResidency::RESIDENT)
+        usage += p_data->get_byte_size();
+    }
+
+  return usage;
+}
+
+NodeHandle Graph::get_node_handle(const std::string &node_id) const
+{
+  auto it = this->nodes.find(node_id);
+  return it == this->nodes.end() ? NodeHandle() : it->second->get_handle();
+}
+
+double Graph::get_cost_estimate(const std::string &node_id) const
+{
+  NodeHandle handle = this->get_node_handle(node_id);
+
+  if (!this->is_handle_valid(handle))
+    throw std::runtime_error("Unknown node ID: " + node_id);
+
+  return this->get_slot_cost(handle.index);
+}
+
+const std::string &Graph::get_node_id(NodeHandle handle) const
+{
+  static const std::string no_id = "";
+
+  if (!this->is_handle_valid(handle)) return no_id;
+  return this->slots[handle.index].id;
+}
+
+std::vector<std::string> Graph::get_nodes_to_update(
+    const std::vector<std::string> &node_ids)
+{
+  uint32_t epoch;
+
+  std::vector<std::string> sorted;
+  for (uint32_t index : this->get_slots_to_update(node_ids, epoch))
+    sorted.push_back(this->slots[index].id);
+
+  return sorted;
+}
+
+std::vector<std::string> Graph::get_nodes_to_update(const std::string &node_id)
+{
+  return this->get_nodes_to_update(std::vector<std::string>{node_id});
+}
+
+double Graph::get_slot_cost(uint32_t index) const
+{
+  const NodeSlot &slot = this->slots[index];
+
+  if (slot.cost >= 0.0) return slot.cost;
+
+  auto it = this->cost_seeds.find(slot.p_node->get_label());
+  return it == this->cost_seeds.end() ? default_cost : it->second;
+}
+
+std::vector<uint32_t> Graph::get_slots_to_update(
+    const std::vector<std::string> &node_ids,
+    uint32_t                       &epoch)
+{
+  epoch = 0;
+
+  // --- validate input nodes
+
+  std::vector<uint32_t> roots;
+  roots.reserve(node_ids.size());
+
+  for (const auto &node_id : node_ids)
+  {
+    NodeHandle handle = this->get_node_handle(node_id);
+
+    if (!this->is_handle_valid(handle))
+    {
+      Logger::log()->trace("Graph::update: unknown node id {}", node_id);
+      return {};
+    }
+
+    roots.push_back(handle.index);
+  }
+
+  // --- collect downstream dirty nodes
+
+  epoch = this->new_mark_epoch();
+
+  std::vector<uint32_t> dirty_slots = this->mark_downstream(roots, epoch);
+
+  // --- check upstream dependencies, nodes updated along with the roots
+  // --- excepted
+
+  for (uint32_t index : roots)
+  {
+    for (const auto &edge : this->slots[index].upstream)
+    {
+      const NodeSlot &prev = this->slots[edge.node.index];
+
+      if (prev.mark != epoch && prev.p_node->is_dirty)
+      {
+        Logger::log()->trace("Graph::update: no update of the graph");
+        return {};
+      }
+    }
+  }
+
+  // --- topological ordering of the dirty cone
+
+  return this->topological_sort_slots(dirty_slots, epoch);
+}
+
+void Graph::mark_dirty(const std::vector<std::string> &node_ids)
+{
+  std::vector<uint32_t> roots;
+  roots.reserve(node_ids.size());
+
+  for (const auto &node_id : node_ids)
+  {
+    if (this->is_node_id_available(node_id))
+      throw std::runtime_error("Unknown node ID: " + node_id);
+
+    roots.push_back(this->nodes.at(node_id)->get_handle().index);
+  }
+
+  this->flag_dirty(this->mark_downstream(roots, this->new_mark_epoch()),
+                   roots);
+}
+
+void Graph::mark_dirty(const std::string &node_id)
+{
+  this->mark_dirty(std::vector<std::string>{node_id});
+}
+
+std::vector<uint32_t> Graph::mark_downstream(
+    const std::vector<uint32_t> &roots,
+    uint32_t                     epoch) const
+{
+  // iterative traversal, each node being visited once thanks to the epoch
+  // marks
+  std::vector<uint32_t> marked = {};
+  std::vector<uint32_t> stack = {};
+
+  for (uint32_t index : roots)
+    if (this->slots[index].mark != epoch)
+    {
+      this->slots[index].mark = epoch;
+      stack.push_back(index);
+    }
+
+  while (!stack.empty())
+  {
+    const uint32_t index = stack.back();
+    stack.pop_back();
+    marked.push_back(index);
+
+    for (const auto &edge : this->slots[index].downstream)
+      if (this->slots[edge.node.index].mark != epoch)
+      {
+        this->slots[edge.node.index].mark = epoch;
+        stack.push_back(edge.node.index);
+      }
+  }
+
+  return marked;
+}
+
+UpdateProgress Graph::get_update_progress() const
+{
+  UpdateProgress progress;
+
+  progress.nodes_done = this->progress_nodes_done;
+  progress.nodes_total = this->progress_nodes_total;
+
+  const double cost_done = this->progress_cost_done;
+  const double cost_total = this->progress_cost_total;
+
+  if (cost_total > 0.0)
+    progress.fraction = static_cast<float>(std::min(1.0,
+                                                    cost_done / cost_total));
+  else if (progress.nodes_total > 0)
+    progress.fraction = static_cast<float>(progress.nodes_done) /
+                        static_cast<float>(progress.nodes_total);
+
+  progress.time_remaining = std::max(0.0, cost_total - cost_done) /
+                            this->progress_parallelism;
+
+  return progress;
+}
+
+std::vector<uint32_t> Graph::mark_upstream(
+    const std::vector<uint32_t> &roots,
+    uint32_t                     epoch) const
+{
+  std::vector<uint32_t> marked = {};
+  std::vector<uint32_t> stack = {};
+
+  for (uint32_t index : roots)
+    if (this->slots[index].mark != epoch)
+    {
+      this->slots[index].mark = epoch;
+      stack.push_back(index);
+    }
+
+  while (!stack.empty())
+  {
+    const uint32_t index = stack.back();
+    stack.pop_back();
+    marked.push_back(index);
+
+    for (const auto &edge : this->slots[index].upstream)
+      if (this->slots[edge.node.index].mark != epoch)
+      {
+        this->slots[edge.node.index].mark = epoch;
+        stack.push_back(edge.node.index);
+      }
+  }
+
+  return marked;
+}
+
+const std::vector<std::string> &Graph::get_topological_order() const
+{
+  if (this->is_topology_dirty)
+  {
+    this->topological_slots.clear();
+    this->topological_slots.reserve(this->nodes.size());
+
+    for (uint32_t index = 0; index < this->slots.size(); ++index)
+      if (this->slots[index].p_node) this->topological_slots.push_back(index);
+
+    std::sort(this->topological_slots.begin(),
+              this->topological_slots.end(),
+              [this](uint32_t a, uint32_t b)
+              { return this->slots[a].rank < this->slots[b].rank; });
+
+    this->topological_order.clear();
+    this->topological_order.reserve(this->topological_slots.size());
+
+    for (uint32_t index : this->topological_slots)
+    {
+      this->slots[index].order_pos = static_cast<uint32_t>(
+          this->topological_order.size());
+      this->topological_order.push_back(this->slots[index].id);
+    }
+
+    this->is_topology_dirty = false;
+    this->topological_removed = 0;
+  }
+  else if (this->topological_removed > 0)
+  {
+    // entries of the removed nodes dropped in a single pass
+    size_t kept = 0;
+
+    for (size_t k = 0; k < this->topological_slots.size(); ++k)
+    {
+      const uint32_t index = this->topological_slots[k];
+      if (index == NodeHandle::invalid_index) continue;
+
+      if (kept != k)
+      {
+        this->topological_slots[kept] = index;
+        this->topological_order[kept] = std::move(this->topological_order[k]);
+        this->slots[index].order_pos = static_cast<uint32_t>(kept);
+      }
+      kept++;
+    }
+
+    this->topological_slots.resize(kept);
+    this->topological_order.resize(kept);
+    this->topological_removed = 0;
+  }
+
+  return this->topological_order;
+}
+
+bool Graph::has_cycle() const
+{
+  return this->get_topological_order().size() != this->nodes.size();
+}
+
+bool Graph::is_node_id_available(const std::string &node_id)
+{
+  return !this->nodes.contains(node_id);
+}
+
+bool Graph::is_output_connected(const std::string &node_id,
+                                int                port_index) const
+{
+  return this->is_output_connected(this->get_node_handle(node_id), port_index);
+}
+
+bool Graph::is_output_connected(NodeHandle handle, int port_index) const
+{
+  for (const auto &edge : this->get_edges_downstream(handle))
+    if (edge.port_from == port_index) return true;
+
+  return false;
+}
+
+bool Graph::is_reachable(const std::string                     &start,
+                         const std::string                     &target,
+                         const std::unordered_set<std::string> &visited) const
+{
+  if (start == target) return true;
+  if (visited.contains(start)) return false;
+
+  const NodeHandle h_start = this->get_node_handle(start);
+  const NodeHandle h_target = this->get_node_handle(target);
+
+  if (!this->is_handle_valid(h_start) || !this->is_handle_valid(h_target))
+    return false;
+
+  const uint32_t epoch = this->new_mark_epoch();
+
+  for (const auto &node_id : visited)
+  {
+    NodeHandle handle = this->get_node_handle(node_id);
+    if (this->is_handle_valid(handle)) this->slots[handle.index].mark = epoch;
+  }
+
+  // in an acyclic graph, a path to the target only goes through nodes ranked
+  // before it
+  const size_t target_rank = this->slots[h_target.index].rank;
+
+  std::vector<uint32_t> stack = {h_start.index};
+  this->slots[h_start.index].mark = epoch;
+
+  while (!stack.empty())
+  {
+    const uint32_t index = stack.back();
+    stack.pop_back();
+
+    for (const auto &edge : this->slots[index].downstream)
+    {
+      const NodeSlot &next = this->slots[edge.node.index];
+
+      if (edge.node.index == h_target.index) return true;
+
+      if (next.rank < target_rank && next.mark != epoch)
+      {
+        next.mark = epoch;
+        stack.push_back(edge.node.index);
+      }
+    }
+  }
+
+  return false;
+}
+
+bool Graph::is_sole_consumer(NodeHandle handle, int port_index) const
+{
+  if (!this->is_handle_valid(handle) || this->is_evaluating_variants)
+    return false;
+
+  // the link the input is bound to, the most recent one when several links
+  // end on the port
+  const size_t row = this->link_table.find_input(handle.index, port_index);
+  if (row == LinkTable::npos) return false;
+
+  const uint32_t from = this->link_table.from[row];
+  const int      port_from = this->link_table.port_from[row];
+
+  for (const auto &other : this->slots[from].downstream)
+    if (other.port_from == port_from &&
+        (other.node != handle || other.port_to != port_index))
+      return false;
+
+  std::shared_ptr<BaseData> p_data = this->slots[from].p_node->get_output_data(
+      port_from);
+
+  return p_data && !p_data->is_pinned() &&
+         p_data->get_residency() == DataResidency::RESIDENT;
+}
+
+uint32_t Graph::new_mark_epoch() const
+{
+  // on wrap-around, reset all the marks to make sure no slot is seen as
+  // already visited
+  if (++this->mark_epoch == 0)
+  {
+    for (const auto &slot : this->slots)
+      slot.mark = 0;
+    this->mark_epoch = 1;
+  }
+
+  return this->mark_epoch;
+}
+
+// connect two nodes, the port data types being checked (type IDs)
+bool Graph::new_link(const std::string &from,
+                     int                port_from,
+                     const std::string &to,
+                     int                port_to)
+{
+  // Get the output data from the source node
+  auto from_node_it = this->nodes.find(from);
+  if (from_node_it == this->nodes.end())
+    throw std::runtime_error("Source node not found: " + from);
+
+  auto to_node_it = this->nodes.find(to);
+  if (to_node_it == this->nodes.end())
+    throw std::runtime_error("Destination node not found: " + to);
+
+  const NodeHandle h_from = from_node_it->second->get_handle();
+  const NodeHandle h_to = to_node_it->second->get_handle();
+
+  // Check the data types, the input would not be bound otherwise
+  if (from_node_it->second->get_data_type_id(port_from) !=
+      to_node_it->second->get_data_type_id(port_to))
+    throw std::invalid_argument(
+        "Data type mismatch: " + from + " [" +
+        from_node_it->second->get_data_type(port_from) + "] -> " + to + " [" +
+        to_node_it->second->get_data_type(port_to) + "]");
+
+  // Check if the link already exists
+  if (this->link_table.find(h_from.index, port_from, h_to.index, port_to) !=
+      LinkTable::npos)
+    return false;
+
+  // Reject links creating a cycle
+  if (!this->update_topological_rank(h_from.index, h_to.index))
+  {
+    Logger::log()->warn("Graph::new_link: link {} -> {} would create a cycle",
+                        from,
+                        to);
+    return false;
+  }
+
+  std::shared_ptr<BaseData> from_data = from_node_it->second->get_output_data(
+      port_from);
+
+  // Set the input data on the destination node
+  to_node_it->second->set_input_data(from_data, port_to);
+
+  // Add the new link to the list of links, to the link table and to the
+  // adjacency index
+  std::vector<Edge> &dw = this->slots[h_from.index].downstream;
+  std::vector<Edge> &up = this->slots[h_to.index].upstream;
+
+  size_t row = this->link_table.push_back(h_from.index,
+                                          port_from,
+                                          h_to.index,
+                                          port_to);
+
+  this->links.emplace_back(from, port_from, to, port_to);
+  this->link_rows.push_back(row);
+  this->link_table.pos_downstream[row] = static_cast<uint32_t>(dw.size());
+  this->link_table.pos_upstream[row] = static_cast<uint32_t>(up.size());
+  dw.push_back({h_to, port_from, port_to});
+  up.push_back({h_from, port_from, port_to});
+
+  // the node has not seen the data of the new link yet
+  this->slots[h_to.index].is_forced = true;
+  this->topology_version++;
+
+  return true;
+}
+
+bool Graph::new_link(const std::string &from,
+                     const std::string &port_label_from,
+                     const std::string &to,
+                     const std::string &port_label_to)
+{
+  // Check that the 'from' port is an output port
+  if (this->nodes.at(from)->get_port_type(port_label_from) != PortType::OUT)
+    throw std::invalid_argument("Port '" + port_label_from + "' on node '" +
+                                from + "' must be an output port.");
+
+  // Check that the 'to' port is an input port
+  if (this->nodes.at(to)->get_port_type(port_label_to) != PortType::IN)
+    throw std::invalid_argument("Port '" + port_label_to + "' on node '" + to +
+                                "' must be an input port.");
+
+  // Call the existing connect method using the port indices
+  return this->new_link(from,
+                        this->nodes.at(from)->get_port_index(port_label_from),
+                        to,
+                        this->nodes.at(to)->get_port_index(port_label_to));
+}
+
+void Graph::set_executor(std::shared_ptr<Executor> new_executor)
+{
+  if (new_executor)
+    this->executor = new_executor;
+  else
+    this->executor = std::make_shared<SerialExecutor>();
+}
+
+bool Graph::poll_updates()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->pending_mutex);
+
+    if (this->pending_ids.empty()) return false;
+
+    const auto now = std::chrono::steady_clock::now();
+
+    const std::chrono::duration<double> quiet = now -
+                                                this->pending_last_request;
+    const std::chrono::duration<double> waiting = now -
+                                                  this->pending_first_request;
+
+    if (quiet.count() < this->update_debounce &&
+        waiting.count() < this->update_latency_budget)
+      return false;
+  }
+
+  return this->flush_updates();
+}
 
 void Graph::print()
 {
@@ -422,220 +1695,1152 @@ void Graph::print()
 
   // --- Nodes
 
-  std::size_t max_id = 2;
-  std::size_t max_label = 5;
-  for (const auto &[id, p_node] : this->nodes)
+  std::size_t max_id = 2;
+  std::size_t max_label = 5;
+  for (const auto &[id, p_node] : this->nodes)
+  {
+    max_id = std::max(max_id, id.size());
+    max_label = std::max(max_label, p_node->get_label().size());
+  }
+
+  std::cout << "\n  " << std::left << std::setw(max_id) << "id" << "   "
+            << std::left << std::setw(max_label) << "label" << "   "
+            << "dirty\n";
+  std::cout << "  " << std::string(max_id + max_label + 13, '-') << "\n";
+
+  for (const auto &[id, p_node] : this->nodes)
+    std::cout << "  " << std::left << std::setw(max_id) << id << "   "
+              << std::left << std::setw(max_label) << p_node->get_label()
+              << "   " << std::boolalpha << p_node->is_dirty << "\n";
+  std::cout << "\n";
+
+  // --- Links
+
+  for (const auto &link : this->get_links())
+  {
+    LinkView view(link, *this->nodes.at(link.from), *this->nodes.at(link.to));
+    view.print(/* indent */ 2);
+  }
+  std::cout << "\n";
+}
+
+void Graph::rebind_input(uint32_t to, int port_to)
+{
+  // still fed by a link, nothing to do
+  if (this->link_table.find_input(to, port_to) != LinkTable::npos) return;
+
+  // look for another link ending on the port, the most recent one taking over
+  size_t row = LinkTable::npos;
+
+  for (const auto &edge : this->slots[to].upstream)
+  {
+    if (edge.port_to != port_to) continue;
+
+    size_t candidate = this->link_table.find(edge.node.index,
+                                             edge.port_from,
+                                             to,
+                                             port_to);
+
+    if (row == LinkTable::npos || candidate > row) row = candidate;
+  }
+
+  Node *p_to = this->slots[to].p_node;
+
+  if (row == LinkTable::npos)
+  {
+    p_to->set_input_data(nullptr, port_to);
+    return;
+  }
+
+  Node *p_from = this->slots[this->link_table.from[row]].p_node;
+
+  this->link_table.index_input(row);
+  p_to->set_input_data(p_from->get_output_data(this->link_table.port_from[row]),
+                       port_to);
+}
+
+bool Graph::remove_link(const std::string &from,
+                        int                port_from,
+                        const std::string &to,
+                        int                port_to)
+{
+  const NodeHandle h_from = this->get_node_handle(from);
+  const NodeHandle h_to = this->get_node_handle(to);
+
+  if (!h_from.is_valid() || !h_to.is_valid()) return false;
+
+  // Check if the link exists
+  size_t row = this->link_table.find(h_from.index,
+                                     port_from,
+                                     h_to.index,
+                                     port_to);
+  if (row == LinkTable::npos) return false;
+
+  // Remove the link from the adjacency index and from the link table (the
+  // link storage being updated lazily), then disconnect the input unless
+  // another link feeds it
+  this->erase_link(row);
+  this->rebind_input(h_to.index, port_to);
+
+  // Reclaim the removed rows once they make up most of the storage
+  if (2 * this->link_table.get_erased_count() > this->link_table.size())
+    this->compact_links();
+
+  return true;
+}
+
+bool Graph::remove_link(const std::string &from,
+                        const std::string &port_label_from,
+                        const std::string &to,
+                        const std::string &port_label_to)
+{
+  // Check that the 'from' port is an output port
+  if (this->nodes.at(from)->get_port_type(port_label_from) != PortType::OUT)
+    throw std::invalid_argument("Port '" + port_label_from + "' on node '" +
+                                from + "' must be an output port.");
+
+  // Check that the 'to' port is an input port
+  if (this->nodes.at(to)->get_port_type(port_label_to) != PortType::IN)
+    throw std::invalid_argument("Port '" + port_label_to + "' on node '" + to +
+                                "' must be an input port.");
+
+  // Call the existing connect method using the port indices
+  return this->remove_link(
+      from,
+      this->nodes.at(from)->get_port_index(port_label_from),
+      to,
+      this->nodes.at(to)->get_port_index(port_label_to));
+}
+
+void Graph::release_input(NodeHandle handle, int port_index)
+{
+  if (!this->is_handle_valid(handle)) return;
+
+  // the output the input is bound to, see is_sole_consumer
+  const size_t row = this->link_table.find_input(handle.index, port_index);
+  if (row == LinkTable::npos) return;
+
+  Node            *p_from = this->slots[this->link_table.from[row]].p_node;
+  const int        port_from = this->link_table.port_from[row];
+  const NodeHandle from = p_from->get_handle();
+
+  p_from->get_output_data(port_from)->drop([this, from]()
+                                           { this->restore_outputs(from); });
+
+  Logger::log()->trace("Graph::release_input: output {} of node {}({}) "
+                       "taken over",
+                       p_from->get_port_label(port_from),
+                       p_from->get_label(),
+                       p_from->get_id());
+}
+
+void Graph::request_update(const std::string &node_id)
+{
+  if (this->is_node_id_available(node_id))
+    throw std::runtime_error("Unknown node ID: " + node_id);
+
+  this->nodes.at(node_id)->is_dirty = true;
+
+  std::lock_guard<std::mutex> lock(this->pending_mutex);
+
+  const auto now = std::chrono::steady_clock::now();
+
+  if (this->pending_ids.empty()) this->pending_first_request = now;
+  this->pending_last_request = now;
+
+  if (!contains(this->pending_ids, node_id))
+    this->pending_ids.push_back(node_id);
+}
+
+void Graph::remove_node(const std::string &id)
+{
+  if (this->is_node_id_available(id))
+    throw std::runtime_error("Unknown node ID: " + id);
+
+  Node          *p_node = this->nodes.at(id).get();
+
+  this->discard_evicted_outputs(p_node);
+
+  const uint32_t index = p_node->get_handle().index;
+  NodeSlot      &slot = this->slots[index];
+
+  // Remove the links associated with the node, only the node neighbours
+  // being visited
+  const std::vector<Edge> downstream = slot.downstream;
+
+  while (!slot.downstream.empty())
+  {
+    const Edge edge = slot.downstream.back();
+    this->erase_link(this->link_table.find(index,
+                                           edge.port_from,
+                                           edge.node.index,
+                                           edge.port_to));
+  }
+
+  while (!slot.upstream.empty())
+  {
+    const Edge edge = slot.upstream.back();
+    this->erase_link(this->link_table.find(edge.node.index,
+                                           edge.port_from,
+                                           index,
+                                           edge.port_to));
+  }
+
+  // Disconnect the inputs the node was feeding
+  for (const auto &edge : downstream)
+    this->rebind_input(edge.node.index, edge.port_to);
+
+  if (2 * this->link_table.get_erased_count() > this->link_table.size())
+    this->compact_links();
+
+  // Release the slot, remaining ranks are still a valid topological order
+  slot.p_node = nullptr;
+  slot.id.clear();
+  slot.generation++;
+  slot.cost = -1.0;
+  slot.has_hash = false;
+  slot.is_forced = true;
+  slot.upstream.clear();
+  slot.downstream.clear();
+  this->free_slots.push_back(index);
+  this->topology_version++;
+
+  // the cached order is kept rather than sorted again, the entry of the node
+  // being dropped the next time the order is read
+  if (!this->is_topology_dirty)
+  {
+    this->topological_slots[slot.order_pos] = NodeHandle::invalid_index;
+    this->topological_removed++;
+  }
+
+  // Remove the node from the graph
+  p_node->set_handle(NodeHandle());
+  this->nodes.erase(id);
+}
+
+void Graph::restore_outputs(NodeHandle handle)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->restore_mutex);
+
+  // re-entry from the recomputation below, or node removed meanwhile
+  if (contains(this->restoring_slots, handle.index) ||
+      !this->is_handle_valid(handle))
+    return;
+
+  Node *p_node = this->slots[handle.index].p_node;
+  bool  is_dropped = false;
+
+  // spilled outputs are read back, dropped ones (or unreadable spill files)
+  // require a recomputation
+  for (const auto &port : p_node->get_ports())
+  {
+    if (port->get_port_type() != PortType::OUT) continue;
+
+    std::shared_ptr<BaseData> p_data = port->get_data_shared_ptr_downcasted();
+    if (!p_data) continue;
+
+    if (p_data->get_residency() == DataResidency::SPILLED && !p_data->reload())
+      is_dropped = true;
+    else if (p_data->get_residency() == DataResidency::DROPPED)
+      is_dropped = true;
+  }
+
+  if (!is_dropped) return;
+
+  Logger::log()->trace("Graph::restore_outputs: recomputing node: {}({})",
+                       p_node->get_label(),
+                       p_node->get_id());
+
+  // the inputs are unchanged, the node is left in its current state
+  const bool is_dirty = p_node->is_dirty;
+
+  this->restoring_slots.push_back(handle.index);
+  p_node->is_dirty = true;
+
+  try
+  {
+    p_node->update();
+  }
+  catch (...)
+  {
+    this->restoring_slots.pop_back();
+    p_node->is_dirty = is_dirty;
+    throw;
+  }
+
+  this->restoring_slots.pop_back();
+  p_node->is_dirty = is_dirty;
+  this->discard_evicted_outputs(p_node);
+}
+
+std::vector<std::string> Graph::topological_sort(
+    const std::vector<std::string> &dirty_node_ids) const
+{
+  // mark the nodes to sort, dropping unknown IDs and duplicates
+  const uint32_t        epoch = this->new_mark_epoch();
+  std::vector<uint32_t> subset;
+  subset.reserve(dirty_node_ids.size());
+
+  for (const auto &node_id : dirty_node_ids)
+  {
+    NodeHandle handle = this->get_node_handle(node_id);
+
+    if (this->is_handle_valid(handle) &&
+        this->slots[handle.index].mark != epoch)
+    {
+      this->slots[handle.index].mark = epoch;
+      subset.push_back(handle.index);
+    }
+  }
+
+  std::vector<std::string> sorted;
+  sorted.reserve(subset.size());
+
+  for (uint32_t index : this->topological_sort_slots(subset, epoch))
+    sorted.push_back(this->slots[index].id);
+
+  return sorted;
+}
+
+std::vector<uint32_t> Graph::topological_sort_slots(
+    const std::vector<uint32_t> &subset,
+    uint32_t                     epoch) const
+{
+  // count number of inputs that are also in the subset
+  for (uint32_t index : subset)
+  {
+    uint32_t deg = 0;
+
+    for (const auto &edge : this->slots[index].upstream)
+      if (this->slots[edge.node.index].mark == epoch) deg++;
+
+    this->slots[index].in_degree = deg;
+  }
+
+  // collect nodes with no dependencies within the subset, the sorted list is
+  // then used as the FIFO queue of ready nodes
+  std::vector<uint32_t> sorted;
+  sorted.reserve(subset.size());
+
+  for (uint32_t index : subset)
+    if (this->slots[index].in_degree == 0) sorted.push_back(index);
+
+  for (size_t head = 0; head < sorted.size(); ++head)
+    for (const auto &edge : this->slots[sorted[head]].downstream)
+    {
+      const NodeSlot &next = this->slots[edge.node.index];
+
+      if (next.mark == epoch && --next.in_degree == 0)
+        sorted.push_back(edge.node.index);
+    }
+
+  return sorted;
+}
+
+bool Graph::run_async_update(const std::vector<std::string>           &node_ids,
+                             const std::vector<std::string>           &root_ids,
+                             const std::shared_ptr<CancellationToken> &token)
+{
+  if (token->is_cancelled()) return false;
+
+  // the nodes downstream of the requested nodes are outdated, they are
+  // flagged up front so that an interrupted update leaves them dirty
+  std::vector<uint32_t> roots;
+
+  for (const auto &node_id : node_ids)
+  {
+    NodeHandle handle = this->get_node_handle(node_id);
+    if (this->is_handle_valid(handle)) roots.push_back(handle.index);
+  }
+
+  this->flag_dirty(this->mark_downstream(roots, this->new_mark_epoch()),
+                   roots);
+
+  // the nodes of the preempted updates are updated along, those already up
+  // to date being skipped
+  std::vector<std::string> valid_ids;
+
+  for (const auto &node_id : root_ids)
+    if (!this->is_node_id_available(node_id)) valid_ids.push_back(node_id);
+
+  uint32_t              epoch;
+  std::vector<uint32_t> sorted_slots = this->get_slots_to_update(valid_ids,
+                                                                 epoch);
+
+  std::vector<std::string> sorted_id;
+  sorted_id.reserve(sorted_slots.size());
+
+  for (uint32_t index : sorted_slots)
+    sorted_id.push_back(this->slots[index].id);
+
+  if (!this->update_slots(sorted_slots, sorted_id, epoch, token.get()))
+    return false;
+
+  {
+    std::lock_guard<std::mutex> lock(this->async_mutex);
+    if (this->async_token == token) this->async_roots.clear();
+  }
+
+  this->post_update();
+  return true;
+}
+
+void Graph::run()
+{
+  // the plan is not meant to run alongside an asynchronous update
+  this->cancel_update();
+  this->wait_update();
+
+  if (!this->is_compiled()) this->compile();
+
+  const ExecutionPlan &plan = *this->plan;
+  const uint32_t       n = static_cast<uint32_t>(plan.nodes.size());
+
+  // the output hashes are not kept up to date by the plan
+  for (uint32_t k = 0; k < n; ++k)
+  {
+    plan.nodes[k]->is_dirty = true;
+    this->slots[plan.slots[k]].has_hash = false;
+  }
+
+  auto run_task = [this, &plan](uint32_t k)
+  {
+    Node *p_node = plan.nodes[k];
+
+    // evicted outputs are about to be overwritten
+    this->discard_evicted_outputs(p_node);
+    p_node->update(/* use_caches */ false);
+  };
+
+  if (this->deterministic || this->executor->get_concurrency() == 1)
+    for (uint32_t k = 0; k < n; ++k)
+      run_task(k);
+  else
+    this->executor->run(plan.tasks, run_task);
+
+  this->enforce_memory_budget();
+
+  this->post_update();
+}
+
+bool Graph::update_topological_rank(uint32_t from, uint32_t to)
+{
+  if (from == to) return false;
+
+  const size_t lb = this->slots[to].rank;
+  const size_t ub = this->slots[from].rank;
+
+  // already ordered, nothing to do
+  if (ub < lb) return true;
+
+  // forward search from the destination, restricted to the nodes ranked
+  // before the source, reaching the source means a cycle
+  std::vector<uint32_t> delta_f = {};
+  std::vector<uint32_t> stack = {to};
+  uint32_t              epoch = this->new_mark_epoch();
+
+  this->slots[to].mark = epoch;
+
+  while (!stack.empty())
+  {
+    const uint32_t index = stack.back();
+    stack.pop_back();
+
+    for (const auto &edge : this->slots[index].downstream)
+    {
+      NodeSlot &next = this->slots[edge.node.index];
+
+      if (next.rank == ub) return false;
+      if (next.rank < ub && next.mark != epoch)
+      {
+        next.mark = epoch;
+        stack.push_back(edge.node.index);
+      }
+    }
+
+    delta_f.push_back(index);
+  }
+
+  // backward search from the source, restricted to the nodes ranked after
+  // the destination
+  std::vector<uint32_t> delta_b = {};
+
+  stack = {from};
+  epoch = this->new_mark_epoch();
+  this->slots[from].mark = epoch;
+
+  while (!stack.empty())
+  {
+    const uint32_t index = stack.back();
+    stack.pop_back();
+
+    for (const auto &edge : this->slots[index].upstream)
+    {
+      NodeSlot &prev = this->slots[edge.node.index];
+
+      if (prev.rank > lb && prev.mark != epoch)
+      {
+        prev.mark = epoch;
+        stack.push_back(edge.node.index);
+      }
+    }
+
+    delta_b.push_back(index);
+  }
+
+  // reassign the ranks of the affected region: upstream part of the source
+  // first, then downstream part of the destination
+  auto by_rank = [this](uint32_t a, uint32_t b)
+  { return this->slots[a].rank < this->slots[b].rank; };
+
+  std::sort(delta_b.begin(), delta_b.end(), by_rank);
+  std::sort(delta_f.begin(), delta_f.end(), by_rank);
+
+  std::vector<size_t> pool;
+  pool.reserve(delta_b.size() + delta_f.size());
+
+  for (uint32_t index : delta_b)
+    pool.push_back(this->slots[index].rank);
+  for (uint32_t index : delta_f)
+    pool.push_back(this->slots[index].rank);
+
+  std::sort(pool.begin(), pool.end());
+
+  size_t k = 0;
+  for (uint32_t index : delta_b)
+    this->slots[index].rank = pool[k++];
+  for (uint32_t index : delta_f)
+    this->slots[index].rank = pool[k++];
+
+  this->is_topology_dirty = true;
+  return true;
+}
+
+void Graph::update()
+{
+  Logger::log()->trace("Updating graph...");
+
+  // set all nodes to a "dirty" state
+  for (const auto &[_, p_node] : this->nodes)
   {
-    max_id = std::max(max_id, id.size());
-    max_label = std::max(max_label, p_node->get_label().size());
+    p_node->is_dirty = true;
+    this->slots[p_node->get_handle().index].is_forced = true;
   }
 
-  std::cout << "\n  " << std::left << std::setw(max_id) << "id" << "   "
-            << std::left << std::setw(max_label) << "label" << "   "
-            << "dirty\n";
-  std::cout << "  " << std::string(max_id + max_label + 13, '-') << "\n";
+  // the topological order is only recomputed after a structural change
+  const std::vector<std::string> &sorted_id = this->get_topological_order();
 
-  for (const auto &[id, p_node] : this->nodes)
-    std::cout << "  " << std::left << std::setw(max_id) << id << "   "
-              << std::left << std::setw(max_label) << p_node->get_label()
-              << "   " << std::boolalpha << p_node->is_dirty << "\n";
-  std::cout << "\n";
+  Logger::log()->trace("Graph::update: update queue:");
+  for (const auto &s : sorted_id)
+    Logger::log()->trace("Graph::update: node id: {}", s);
 
-  // --- Links
+  const uint32_t epoch = this->new_mark_epoch();
 
-  for (const auto &link : this->links)
-  {
-    LinkView view(link, *this->nodes.at(link.from), *this->nodes.at(link.to));
-    view.print(/* indent */ 2);
-  }
-  std::cout << "\n";
+  for (uint32_t index : this->topological_slots)
+    this->slots[index].mark = epoch;
+
+  this->update_slots(this->topological_slots, sorted_id, epoch);
+
+  this->post_update();
 }
 
-bool Graph::remove_link(const std::string &from,
-                        int                port_from,
-                        const std::string &to,
-                        int                port_to)
+void Graph::update(const std::vector<std::string> &node_ids)
 {
-  Link link(from, port_from, to, port_to);
+  for (const auto &node_id : node_ids)
+  {
+    if (this->is_node_id_available(node_id))
+    {
+      Logger::log()->trace("Graph::update: unknown node id {}", node_id);
+      return;
+    }
+  }
 
-  // Check if the link exists
-  auto link_it = std::find(this->links.begin(), this->links.end(), link);
-  if (link_it == this->links.end()) return false;
+  uint32_t              epoch;
+  std::vector<uint32_t> sorted_slots = this->get_slots_to_update(node_ids,
+                                                                 epoch);
 
-  // Ensure the destination node exists before attempting to disconnect
-  auto to_node_it = this->nodes.find(to);
-  if (to_node_it == this->nodes.end())
-    throw std::runtime_error("Destination node not found: " + to);
+  std::vector<uint32_t> roots;
+  roots.reserve(node_ids.size());
 
-  // Disconnect nodes by setting the input data to null
-  to_node_it->second->set_input_data(nullptr, port_to);
+  for (const auto &node_id : node_ids)
+    roots.push_back(this->nodes.at(node_id)->get_handle().index);
 
-  // Remove the link from the list of links
-  this->links.erase(link_it);
+  if (!sorted_slots.empty()) this->flag_dirty(sorted_slots, roots);
 
-  return true;
+  std::vector<std::string> sorted_id;
+  sorted_id.reserve(sorted_slots.size());
+
+  for (uint32_t index : sorted_slots)
+    sorted_id.push_back(this->slots[index].id);
+
+  this->update_slots(sorted_slots, sorted_id, epoch);
+
+  this->post_update();
 }
 
-bool Graph::remove_link(const std::string &from,
-                        const std::string &port_label_from,
-                        const std::string &to,
-                        const std::string &port_label_to)
+void Graph::update(const std::string &node_id)
 {
-  // Check that the 'from' port is an output port
-  if (this->nodes.at(from)->get_port_type(port_label_from) != PortType::OUT)
-    throw std::invalid_argument("Port '" + port_label_from + "' on node '" +
-                                from + "' must be an output port.");
+  this->update(std::vector<std::string>{node_id});
+}
 
-  // Check that the 'to' port is an input port
-  if (this->nodes.at(to)->get_port_type(port_label_to) != PortType::IN)
-    throw std::invalid_argument("Port '" + port_label_to + "' on node '" + to +
-                                "' must be an input port.");
+std::shared_future<bool> Graph::update_async(
+    const std::vector<std::string> &node_ids)
+{
+  std::lock_guard<std::mutex> lock(this->async_mutex);
 
-  // Call the existing connect method using the port indices
-  return this->remove_link(
-      from,
-      this->nodes.at(from)->get_port_index(port_label_from),
-      to,
-      this->nodes.at(to)->get_port_index(port_label_to));
+  // preempt the update in flight and carry over its nodes
+  if (this->async_token) this->async_token->cancel();
+
+  for (const auto &node_id : node_ids)
+    if (!contains(this->async_roots, node_id))
+      this->async_roots.push_back(node_id);
+
+  auto token = std::make_shared<CancellationToken>();
+  auto previous = this->async_update;
+  auto root_ids = this->async_roots;
+
+  // the new update starts once the preempted one has stopped
+  this->async_token = token;
+  this->async_update = std::async(std::launch::async,
+                                  [this, previous, node_ids, root_ids, token]
+                                  {
+                                    if (previous.valid()) previous.wait();
+                                    return this->run_async_update(node_ids,
+                                                                  root_ids,
+                                                                  token);
+                                  })
+                           .share();
+
+  return this->async_update;
 }
 
-void Graph::remove_node(const std::string &id)
+std::shared_future<bool> Graph::update_async(const std::string &node_id)
 {
-  if (this->is_node_id_available(id))
-    throw std::runtime_error("Unknown node ID: " + id);
+  return this->update_async(std::vector<std::string>{node_id});
+}
+
+bool Graph::update_slots(const std::vector<uint32_t>    &sorted_slots,
+                         const std::vector<std::string> &sorted_ids,
+                         uint32_t                        epoch,
+                         const CancellationToken        *p_token)
+{
+  const size_t n = sorted_slots.size();
+
+  for (size_t k = 0; k < n; ++k)
+    this->slots[sorted_slots[k]].task = static_cast<uint32_t>(k);
+
+  // --- tiled groups: dirty nodes sharing a raster size, all the nodes they
+  // --- depend on within the update belonging to the same group (but for the
+  // --- first node of the group)
+
+  std::vector<TiledGroup> groups;
+  std::vector<int>        group_of(n, -1);
+
+  for (size_t k = 0; k < n && this->tile_size > 0; ++k)
+  {
+    const NodeSlot &slot = this->slots[sorted_slots[k]];
+    if (!slot.p_node->is_dirty) continue;
+
+    std::optional<TilingScheme> tiling = slot.p_node->get_tiling();
+    if (!tiling || tiling->width <= 0 || tiling->height <= 0) continue;
+
+    int  g = -1;
+    bool is_first = true;
+
+    for (const auto &edge : slot.upstream)
+    {
+      const NodeSlot &prev = this->slots[edge.node.index];
+      if (prev.mark != epoch) continue;
+
+      if (is_first)
+        g = group_of[prev.task];
+      else if (group_of[prev.task] != g)
+        g = -1;
+
+      is_first = false;
+    }
+
+    if (g < 0 || groups[g].tiling.width != tiling->width ||
+        groups[g].tiling.height != tiling->height)
+    {
+      g = static_cast<int>(groups.size());
+      groups.emplace_back();
+      groups[g].tiling = *tiling;
+      groups[g].nx = (tiling->width + this->tile_size - 1) / this->tile_size;
+      groups[g].ny = (tiling->height + this->tile_size - 1) / this->tile_size;
+    }
+
+    groups[g].members.push_back(static_cast<uint32_t>(k));
+    groups[g].halos.push_back(std::max(0, tiling->halo));
+    group_of[k] = g;
+  }
+
+  for (int g = 0; g < static_cast<int>(groups.size()); ++g)
+  {
+    TiledGroup  &group = groups[g];
+    const size_t count = group.members.size();
+
+    // margin computed by each node around the tiles, the halos of the nodes
+    // downstream being accumulated
+    group.reach.assign(count, 0);
+
+    for (size_t m = count; m-- > 0;)
+      for (const auto &edge :
+           this->slots[sorted_slots[group.members[m]]].downstream)
+      {
+        const NodeSlot &next = this->slots[edge.node.index];
+        if (next.mark != epoch || group_of[next.task] != g) continue;
+
+        const size_t j = std::lower_bound(group.members.begin(),
+                                          group.members.end(),
+                                          next.task) -
+                         group.members.begin();
+
+        group.reach[m] = std::max(group.reach[m],
+                                  group.reach[j] + group.halos[j]);
+      }
+
+    // tiles computed concurrently never overlap: all at once without halo,
+    // in four phases of tiles two tiles apart if the margin fits in half a
+    // tile, one after the other otherwise
+    const int margin = *std::max_element(group.reach.begin(),
+                                         group.reach.end());
+
+    if (margin == 0)
+      group.phases = 1;
+    else if (2 * margin <= this->tile_size)
+      group.phases = 4;
+    else
+      group.phases = group.nx * group.ny;
+  }
+
+  // --- work items in topological order, a tiled group being run as a
+  // --- preparation, its tiles in phases separated by barriers, and then the
+  // --- updates of its nodes
+
+  std::vector<UpdateItem>            items;
+  std::vector<std::vector<uint32_t>> item_successors;
+  std::vector<uint32_t>              node_item(n);
 
-  // Disconnect node by clearing input data on connected nodes
-  for (const auto &link : this->links)
-    if (link.from == id)
+  items.reserve(n);
+  item_successors.reserve(n);
+
+  auto push_item = [&](UpdateItem item)
+  {
+    items.push_back(item);
+    item_successors.emplace_back();
+    return static_cast<uint32_t>(items.size() - 1);
+  };
+
+  for (size_t k = 0; k < n; ++k)
+  {
+    const int g = group_of[k];
+
+    if (g >= 0 && groups[g].members.front() == k)
     {
-      auto node_it = this->nodes.find(link.to);
-      if (node_it != this->nodes.end())
+      TiledGroup &group = groups[g];
+      const int   tile_count = group.nx * group.ny;
+
+      group.first_item = push_item({UpdateItem::PREPARE, uint32_t(g), 0});
+      uint32_t gate = group.first_item;
+
+      for (int phase = 0; phase < group.phases; ++phase)
       {
-        node_it->second->set_input_data(nullptr, link.port_to);
+        std::vector<uint32_t> tiles;
+
+        for (int tile = 0; tile < tile_count; ++tile)
+          if (helper_get_tile_phase(group, tile) == phase)
+            tiles.push_back(push_item({UpdateItem::TILE, uint32_t(g), tile}));
+
+        const uint32_t barrier = push_item(
+            {UpdateItem::BARRIER, uint32_t(g), phase});
+
+        for (uint32_t tile : tiles)
+        {
+          item_successors[gate].push_back(tile);
+          item_successors[tile].push_back(barrier);
+        }
+
+        item_successors[gate].push_back(barrier);
+        gate = barrier;
       }
+
+      group.last_item = gate;
     }
 
-  // Remove links associated with the node
-  this->links.erase(std::remove_if(this->links.begin(),
-                                   this->links.end(),
-                                   [&id](const Link &link) {
-                                     return link.from == id || link.to == id;
-                                   }),
-                    this->links.end());
+    node_item[k] = push_item({UpdateItem::NODE, uint32_t(k), 0});
+  }
 
-  // Remove the node from the graph
-  this->nodes.erase(id);
-}
+  // consumers of the outputs of each node within the update (one per link)
+  std::vector<uint32_t> consumer_count(n, 0);
 
-std::vector<std::string> Graph::topological_sort(
-    const std::vector<std::string> &dirty_node_ids) const
-{
-  // init
-  std::unordered_map<std::string, int> in_degree;
-  for (const auto &node_id : dirty_node_ids)
-    in_degree[node_id] = 0;
+  for (size_t k = 0; k < n; ++k)
+  {
+    const NodeSlot &slot = this->slots[sorted_slots[k]];
 
-  // node links
-  const auto connectivity_up = this->get_connectivity_upstream();
-  const auto connectivity_dw = this->get_connectivity_downstream();
+    for (const auto &edge : slot.downstream)
+    {
+      const NodeSlot &next = this->slots[edge.node.index];
+      if (next.mark != epoch) continue;
 
-  // count number of inputs that are also dirty
-  for (const auto &node_id : dirty_node_ids)
-    for (const auto &up_id : connectivity_up.at(node_id))
-      if (contains(dirty_node_ids, up_id)) in_degree[node_id]++;
+      const int g = group_of[next.task];
 
-  // collect nodes with no dirty dependencies
-  std::queue<std::string> ready;
-  for (const auto &[node_id, deg] : in_degree)
-    if (deg == 0) ready.push(node_id);
+      if (g >= 0 && groups[g].members.front() == next.task)
+        item_successors[node_item[k]].push_back(groups[g].first_item);
 
-  std::vector<std::string> sorted;
+      item_successors[node_item[k]].push_back(node_item[next.task]);
+      consumer_count[k]++;
+    }
+  }
+
+  for (const auto &group : groups)
+    for (uint32_t k : group.members)
+      item_successors[group.last_item].push_back(node_item[k]);
+
+  // --- dependencies between the items, as task indices
 
-  while (!ready.empty())
+  const size_t item_count = items.size();
+  TaskGraph    tasks;
+
+  tasks.in_degree.resize(item_count, 0);
+  tasks.successor_offsets.reserve(item_count + 1);
+  tasks.successor_offsets.push_back(0);
+
+  for (size_t i = 0; i < item_count; ++i)
   {
-    std::string node_id = ready.front();
-    ready.pop();
-    sorted.push_back(node_id);
+    for (uint32_t next : item_successors[i])
+    {
+      tasks.successors.push_back(next);
+      tasks.in_degree[next]++;
+    }
 
-    for (const auto &dw_id : connectivity_dw.at(node_id))
+    tasks.successor_offsets.push_back(
+        static_cast<uint32_t>(tasks.successors.size()));
+  }
+
+  // --- cost model: estimated duration of each task (clean nodes are not
+  // --- recomputed, tiled nodes are computed by the tiles), the priority of
+  // --- a task being the longest path from the task to the end of the update
+
+  std::vector<double> item_cost(item_count, 0.0);
+  std::vector<double> group_cost(groups.size(), 0.0);
+  double              total_cost = 0.0;
+  double              critical_path = 0.0;
+
+  for (size_t k = 0; k < n; ++k)
+    if (this->slots[sorted_slots[k]].p_node->is_dirty)
     {
-      if (!in_degree.contains(dw_id)) continue;
+      const double cost = this->get_slot_cost(sorted_slots[k]);
 
-      in_degree[dw_id]--;
-      if (in_degree[dw_id] == 0) ready.push(dw_id);
+      if (group_of[k] >= 0)
+        group_cost[group_of[k]] += cost;
+      else
+        item_cost[node_item[k]] = cost;
+
+      total_cost += cost;
+    }
+
+  for (size_t i = 0; i < item_count; ++i)
+    if (items[i].kind == UpdateItem::TILE)
+    {
+      const TiledGroup &group = groups[items[i].index];
+      item_cost[i] = group_cost[items[i].index] / (group.nx * group.ny);
     }
+
+  tasks.priority.resize(item_count);
+
+  for (size_t i = item_count; i-- > 0;)
+  {
+    double longest = 0.0;
+
+    for (uint32_t s = tasks.successor_offsets[i];
+         s < tasks.successor_offsets[i + 1];
+         ++s)
+      longest = std::max(longest, tasks.priority[tasks.successors[s]]);
+
+    tasks.priority[i] = item_cost[i] + longest;
+    critical_path = std::max(critical_path, tasks.priority[i]);
   }
 
-  return sorted;
-}
+  SerialExecutor serial_executor;
+  Executor      &executor = this->deterministic ? serial_executor
+                                                : *this->executor;
+  const bool     is_serial = executor.get_concurrency() == 1;
 
-void Graph::update()
-{
-  Logger::log()->trace("Updating graph...");
+  // the work cannot be spread over more threads than the average width of
+  // the task graph
+  double parallelism = 1.0;
 
-  // set all nodes to a "dirty" state
-  std::vector<std::string> dirty_node_ids = {};
+  if (critical_path > 0.0)
+    parallelism = std::clamp(total_cost / critical_path,
+                             1.0,
+                             static_cast<double>(executor.get_concurrency()));
 
-  for (const auto &[nid, _] : this->nodes)
+  this->progress_nodes_done = 0;
+  this->progress_nodes_total = n;
+  this->progress_cost_done = 0.0;
+  this->progress_cost_total = total_cost;
+  this->progress_parallelism = parallelism;
+
+  // --- node updates, the callback calls being serialized for parallel
+  // --- executors
+
+  std::mutex        callback_mutex;
+  std::atomic<bool> is_interrupted = false;
+
+  // outputs changed by each task, only written by the task itself before
+  // its successors start (char rather than bool for concurrent writes)
+  std::vector<char> is_changed(n, 1);
+
+  // batch mode, consumer updates left for each task outputs (one per link)
+  std::unique_ptr<std::atomic<uint32_t>[]> consumers_left;
+
+  if (this->batch_mode)
   {
-    this->get_node_ref_by_id(nid)->is_dirty = true;
-    dirty_node_ids.push_back(nid);
+    consumers_left = std::make_unique<std::atomic<uint32_t>[]>(n);
+
+    for (size_t k = 0; k < n; ++k)
+      consumers_left[k] = consumer_count[k];
   }
 
-  //
-  std::vector<std::string> sorted_id = topological_sort(dirty_node_ids);
+  // tiled groups, computation time of each node over all the tiles and
+  // interruption of the group
+  std::vector<double>                  tile_time(n, 0.0);
+  std::unique_ptr<std::atomic<bool>[]> is_group_interrupted =
+      std::make_unique<std::atomic<bool>[]>(groups.size());
 
-  Logger::log()->trace("Graph::update: update queue:");
-  for (const auto &s : sorted_id)
-    Logger::log()->trace("Graph::update: node id: {}", s);
+  auto notify = [&](const std::string &nid, bool before_update)
+  {
+    if (!this->update_callback) return;
 
-  for (const auto &nid : sorted_id)
+    std::lock_guard<std::mutex> lock(callback_mutex);
+    this->update_callback(nid, sorted_ids, before_update);
+  };
+
+  auto run_task = [&](uint32_t k)
   {
-    if (this->update_callback) this->update_callback(nid, sorted_id, true);
+    const std::string &nid = sorted_ids[k];
+    NodeSlot          &slot = this->slots[sorted_slots[k]];
+    Node              *p_node = slot.p_node;
+    const bool         is_tiled = group_of[k] >= 0;
+
+    // cancellation is checked at node boundaries, the remaining nodes being
+    // left dirty
+    if (p_token && p_token->is_cancelled() && !is_tiled)
+    {
+      is_interrupted = true;
+      return;
+    }
 
-    Logger::log()->trace("Updating node: {}({})",
-                         this->get_node_ref_by_id(nid)->get_label(),
+    if (!is_tiled) notify(nid, true);
+
+    Logger::log()->trace("Graph::update: updating node: {}({})",
+                         p_node->get_label(),
                          nid);
-    this->get_node_ref_by_id(nid)->update();
+    // early cutoff, the update is skipped when the node is only dirty
+    // because of nodes upstream left unchanged by this update
+    if (this->early_cutoff && p_node->is_dirty && !slot.is_forced &&
+        !is_tiled)
+    {
+      bool is_cutoff = false;
 
-    if (this->update_callback) this->update_callback(nid, sorted_id, false);
-  }
+      for (const auto &edge : slot.upstream)
+      {
+        const NodeSlot &prev = this->slots[edge.node.index];
 
-  this->post_update();
-}
+        if (prev.p_node->is_dirty ||
+            (prev.mark == epoch && is_changed[prev.task]))
+        {
+          is_cutoff = false;
+          break;
+        }
 
-void Graph::update(const std::vector<std::string> &node_ids)
-{
-  for (const auto &node_id : node_ids)
+        if (prev.mark == epoch) is_cutoff = true;
+      }
+
+      if (is_cutoff)
+      {
+        Logger::log()->trace("Graph::update: cutoff of node: {}({})",
+                             p_node->get_label(),
+                             nid);
+        p_node->is_dirty = false;
+        is_changed[k] = 0;
+      }
+    }
+
+    // tiled nodes have already been computed by the tiles
+    const bool is_computed = p_node->is_dirty || is_tiled;
+    double     duration = tile_time[k];
+
+    if (!is_tiled)
+    {
+      // evicted outputs are about to be overwritten
+      if (is_computed) this->discard_evicted_outputs(p_node);
+
+      const auto t0 = std::chrono::steady_clock::now();
+
+      p_node->set_cancellation_token(p_token);
+      p_node->update();
+      p_node->set_cancellation_token(nullptr);
+
+      duration = std::chrono::duration<double>(
+                     std::chrono::steady_clock::now() - t0)
+                     .count();
+    }
+
+    if (p_node->is_dirty)
+      is_interrupted = true;
+    else if (is_computed)
+    {
+      slot.cost = slot.cost < 0.0 ? duration
+                                  : cost_smoothing * duration +
+                                        (1.0 - cost_smoothing) * slot.cost;
+      slot.is_forced = false;
+
+      // the hash is only kept up to date while the cutoff is active
+      std::optional<uint64_t> hash;
+      if (this->early_cutoff) hash = p_node->get_output_hash();
+
+      is_changed[k] = !(hash && slot.has_hash && *hash == slot.output_hash);
+      slot.output_hash = hash.value_or(0);
+      slot.has_hash = hash.has_value();
+    }
+
+    // the node and the nodes feeding it have just been used
+    const uint64_t tick = ++this->use_clock;
+
+    std::atomic_ref<uint64_t>(slot.last_use).store(tick,
+                                                   std::memory_order_relaxed);
+    for (const auto &edge : slot.upstream)
+      std::atomic_ref<uint64_t>(this->slots[edge.node.index].last_use)
+          .store(tick, std::memory_order_relaxed);
+
+    // outputs no longer needed by the update
+    if (consumers_left)
+      for (const auto &edge : slot.upstream)
+      {
+        const NodeSlot &prev = this->slots[edge.node.index];
+
+        if (prev.mark == epoch && --consumers_left[prev.task] == 0)
+          this->evict_outputs(edge.node.index, EvictionMode::DROP);
+      }
+
+    // no other node is running with serial executions
+    if (is_serial) this->enforce_memory_budget();
+
+    this->progress_cost_done += item_cost[node_item[k]];
+    this->progress_nodes_done++;
+
+    notify(nid, false);
+  };
+
+  auto run_item = [&](uint32_t i)
   {
-    if (this->is_node_id_available(node_id))
+    const UpdateItem &item = items[i];
+
+    if (item.kind == UpdateItem::NODE)
     {
-      Logger::log()->trace("Graph::update: unknown node id {}", node_id);
+      run_task(item.index);
       return;
     }
-  }
 
-  std::vector<std::string> sorted_id = this->get_nodes_to_update(node_ids);
+    const TiledGroup &group = groups[item.index];
+    std::atomic<bool> &is_group_stopped = is_group_interrupted[item.index];
+
+    if (item.kind == UpdateItem::PREPARE)
+    {
+      for (uint32_t k : group.members)
+      {
+        Node *p_node = this->slots[sorted_slots[k]].p_node;
+
+        notify(sorted_ids[k], true);
+
+        // evicted outputs are about to be overwritten
+        this->discard_evicted_outputs(p_node);
+        p_node->set_cancellation_token(p_token);
+        p_node->begin_tiles();
+      }
+    }
+    else if (item.kind == UpdateItem::TILE)
+    {
+      // cancellation is checked at tile boundaries, the nodes of the group
+      // being left dirty
+      if (is_group_stopped) return;
+
+      if (p_token && p_token->is_cancelled())
+      {
+        is_group_stopped = true;
+        return;
+      }
+
+      const TileRegion tile = helper_get_tile(group,
+                                              this->tile_size,
+                                              item.tile);
+
+      for (size_t m = 0; m < group.members.size(); ++m)
+      {
+        const uint32_t k = group.members[m];
+        const auto     t0 = std::chrono::steady_clock::now();
+
+        this->slots[sorted_slots[k]].p_node->compute_tile(
+            tile.expanded(group.reach[m],
+                          group.tiling.width,
+                          group.tiling.height));
+
+        const std::chrono::duration<double> duration =
+            std::chrono::steady_clock::now() - t0;
+
+        std::atomic_ref<double>(tile_time[k]).fetch_add(duration.count());
+      }
+
+      this->progress_cost_done += item_cost[i];
+    }
+    else if (i == group.last_item)
+    {
+      for (uint32_t k : group.members)
+      {
+        Node *p_node = this->slots[sorted_slots[k]].p_node;
+
+        p_node->end_tiles(!is_group_stopped);
+        p_node->set_cancellation_token(nullptr);
+      }
+    }
+  };
 
-  for (const auto &nid : sorted_id)
+  try
+  {
+    executor.run(tasks, run_item);
+  }
+  catch (...)
   {
-    if (this->update_callback) this->update_callback(nid, sorted_id, true);
+    // tiled updates left unfinished
+    for (const auto &group : groups)
+      for (uint32_t k : group.members)
+      {
+        Node *p_node = this->slots[sorted_slots[k]].p_node;
 
-    Logger::log()->trace("Graph::update: updating node: {}({})",
-                         this->get_node_ref_by_id(nid)->get_label(),
-                         nid);
-    this->get_node_ref_by_id(nid)->is_dirty = true;
-    this->get_node_ref_by_id(nid)->update();
+        p_node->end_tiles(false);
+        p_node->set_cancellation_token(nullptr);
+      }
 
-    if (this->update_callback) this->update_callback(nid, sorted_id, false);
+    throw;
   }
 
-  this->post_update();
+  this->enforce_memory_budget();
+
+  return !is_interrupted;
 }
 
-void Graph::update(const std::string &node_id)
+void Graph::wait_update()
 {
-  this->update(std::vector<std::string>{node_id});
+  std::shared_future<bool> update;
+
+  {
+    std::lock_guard<std::mutex> lock(this->async_mutex);
+    update = this->async_update;
+  }
+
+  if (update.valid()) update.wait();
 }
 
 } // namespace gnode
@@ -24,6 +24,123 @@ void Link::print() const
             << port_to << ")" << std::endl;
 }
 
+// === LinkTable ===
+
+void LinkTable::clear()
+{
+  this->from.clear();
+  this->port_from.clear();
+  this->to.clear();
+  this->port_to.clear();
+  this->pos_downstream.clear();
+  this->pos_upstream.clear();
+  this->rows.clear();
+  this->input_rows.clear();
+  this->erased_count = 0;
+}
+
+void LinkTable::compact()
+{
+  if (this->erased_count == 0) return;
+
+  size_t kept = 0;
+
+  for (size_t row = 0; row < this->size(); ++row)
+  {
+    if (!this->is_alive(row)) continue;
+
+    if (kept != row)
+    {
+      this->from[kept] = this->from[row];
+      this->port_from[kept] = this->port_from[row];
+      this->to[kept] = this->to[row];
+      this->port_to[kept] = this->port_to[row];
+      this->pos_downstream[kept] = this->pos_downstream[row];
+      this->pos_upstream[kept] = this->pos_upstream[row];
+    }
+    kept++;
+  }
+
+  this->from.resize(kept);
+  this->port_from.resize(kept);
+  this->to.resize(kept);
+  this->port_to.resize(kept);
+  this->pos_downstream.resize(kept);
+  this->pos_upstream.resize(kept);
+  this->erased_count = 0;
+
+  this->rebuild_indices();
+}
+
+void LinkTable::erase(size_t row)
+{
+  this->rows.erase(Key{port_key(this->from[row], this->port_from[row]),
+                       port_key(this->to[row], this->port_to[row])});
+
+  auto it = this->input_rows.find(port_key(this->to[row], this->port_to[row]));
+  if (it != this->input_rows.end() && it->second == row)
+    this->input_rows.erase(it);
+
+  this->from[row] = NodeHandle::invalid_index;
+  this->to[row] = NodeHandle::invalid_index;
+  this->erased_count++;
+}
+
+size_t LinkTable::find(uint32_t from,
+                       int      port_from,
+                       uint32_t to,
+                       int      port_to) const
+{
+  auto it = this->rows.find(
+      Key{port_key(from, port_from), port_key(to, port_to)});
+  return it == this->rows.end() ? npos : it->second;
+}
+
+size_t LinkTable::find_input(uint32_t to, int port_to) const
+{
+  auto it = this->input_rows.find(port_key(to, port_to));
+  return it == this->input_rows.end() ? npos : it->second;
+}
+
+void LinkTable::index_input(size_t row)
+{
+  this->input_rows[port_key(this->to[row], this->port_to[row])] = row;
+}
+
+size_t LinkTable::push_back(uint32_t from,
+                            int      port_from,
+                            uint32_t to,
+                            int      port_to)
+{
+  const size_t row = this->size();
+
+  this->from.push_back(from);
+  this->port_from.push_back(port_from);
+  this->to.push_back(to);
+  this->port_to.push_back(port_to);
+  this->pos_downstream.push_back(0);
+  this->pos_upstream.push_back(0);
+
+  this->rows[Key{port_key(from, port_from), port_key(to, port_to)}] = row;
+  this->index_input(row);
+
+  return row;
+}
+
+void LinkTable::rebuild_indices()
+{
+  this->rows.clear();
+  this->input_rows.clear();
+
+  // the last link added to an input port is the one feeding it
+  for (size_t row = 0; row < this->size(); ++row)
+  {
+    this->rows[Key{port_key(this->from[row], this->port_from[row]),
+                   port_key(this->to[row], this->port_to[row])}] = row;
+    this->index_input(row);
+  }
+}
+
 // === LinkView ===
 
 LinkView::LinkView(const Link &link, const Node &node_from, const Node &node_to)
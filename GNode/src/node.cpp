@@ -8,6 +8,62 @@
 namespace gnode
 {
 
+// content address of the node computation, if the node and its inputs can be
+// hashed
+std::optional<CacheKey> helper_get_cache_key(const Node &node)
+{
+  std::optional<uint64_t> parameters_hash = node.get_parameters_hash();
+  if (!parameters_hash) return std::nullopt;
+
+  CacheKey key;
+  key.node_label = node.get_label();
+  key.parameters_hash = *parameters_hash;
+
+  for (const auto &port : node.get_ports())
+  {
+    if (port->get_port_type() != PortType::IN) continue;
+
+    // unconnected inputs are hashed as zero
+    std::shared_ptr<BaseData> p_data = port->get_data_shared_ptr_downcasted();
+    std::optional<uint64_t>   hash = p_data ? p_data->get_hash() : 0;
+
+    if (!hash) return std::nullopt;
+    key.input_hashes.push_back(*hash);
+  }
+
+  return key;
+}
+
+// output data of the node, in port order
+std::vector<std::shared_ptr<BaseData>> helper_get_outputs(const Node &node)
+{
+  std::vector<std::shared_ptr<BaseData>> outputs;
+
+  for (const auto &port : node.get_ports())
+    if (port->get_port_type() == PortType::OUT)
+      outputs.push_back(port->get_data_shared_ptr_downcasted());
+
+  return outputs;
+}
+
+void Node::begin_tiles()
+{
+  this->is_compute_interrupted = false;
+  this->is_computing = true;
+  this->prepare_tiles();
+}
+
+void Node::end_tiles(bool is_complete)
+{
+  this->is_computing = false;
+
+  // an interrupted computation leaves the node dirty
+  if (!is_complete || this->is_compute_interrupted) return;
+
+  this->is_dirty = false;
+  this->publish_outputs();
+}
+
 std::shared_ptr<BaseData> Node::get_base_data(int port_index)
 {
   // Range check for the port index
@@ -35,6 +91,14 @@ std::string Node::get_data_type(int port_index) const
   return this->ports[port_index]->get_data_type();
 }
 
+TypeId Node::get_data_type_id(int port_index) const
+{
+  if (port_index < 0 || port_index >= static_cast<int>(this->ports.size()))
+    throw std::out_of_range("Invalid port index");
+
+  return this->ports[port_index]->get_data_type_id();
+}
+
 std::string Node::get_graph_id() const
 {
   if (this->p_graph)
@@ -64,6 +128,26 @@ std::shared_ptr<BaseData> Node::get_output_data(int port_index) const
   return this->ports[port_index]->get_data_shared_ptr_downcasted();
 }
 
+std::optional<uint64_t> Node::get_output_hash() const
+{
+  uint64_t hash = hash_bytes(nullptr, 0);
+
+  for (const auto &port : this->ports)
+  {
+    if (port->get_port_type() != PortType::OUT) continue;
+
+    std::shared_ptr<BaseData> p_data = port->get_data_shared_ptr_downcasted();
+    if (!p_data) return std::nullopt;
+
+    std::optional<uint64_t> port_hash = p_data->get_hash();
+    if (!port_hash) return std::nullopt;
+
+    hash = hash_bytes(&port_hash.value(), sizeof(uint64_t), hash);
+  }
+
+  return hash;
+}
+
 int Node::get_port_index(const std::string &port_label) const
 {
   for (size_t i = 0; i < this->ports.size(); ++i)
@@ -92,6 +176,16 @@ bool Node::has_port(const std::string &port_label) const
   return this->get_port_index(port_label) != -1;
 }
 
+bool Node::is_cancel_requested() const
+{
+  if (!this->p_cancellation_token) return false;
+
+  if (this->p_cancellation_token->is_cancelled())
+    this->is_compute_interrupted = true;
+
+  return this->is_compute_interrupted;
+}
+
 bool Node::is_port_connected(int port_index) const
 {
   // Range check for the port index
@@ -105,11 +199,7 @@ bool Node::is_port_connected(int port_index) const
   // for an output we have to check if a link exists
   if (!this->p_graph) return false;
 
-  for (const auto &link : this->p_graph->get_links())
-    if (link.from == this->get_id() && port_index == link.port_from)
-      return true;
-
-  return false;
+  return this->p_graph->is_output_connected(this->handle, port_index);
 }
 
 bool Node::is_port_connected(const std::string &port_label) const
@@ -130,13 +220,193 @@ void Node::set_input_data(std::shared_ptr<BaseData> data, int port_index)
   this->ports[port_index]->set_data(std::move(data));
 }
 
-void Node::update()
+void Node::set_input_in_place(const std::string &port_label, bool new_state)
+{
+  int index = this->get_port_index(port_label);
+  if (index == -1) throw std::runtime_error("Port not found: " + port_label);
+
+  if (this->ports[index]->get_port_type() != PortType::IN)
+    throw std::invalid_argument("Invalid port type, should be an input");
+
+  this->ports[index]->set_in_place(new_state);
+}
+
+void Node::set_output_double_buffered(const std::string &port_label,
+                                      bool               new_state)
+{
+  int index = this->get_port_index(port_label);
+  if (index == -1) throw std::runtime_error("Port not found: " + port_label);
+
+  if (this->ports[index]->get_port_type() != PortType::OUT)
+    throw std::invalid_argument("Invalid port type, should be an output");
+
+  this->ports[index]->set_double_buffered(new_state);
+}
+
+void Node::set_output_pinned(const std::string &port_label, bool new_state)
+{
+  int index = this->get_port_index(port_label);
+  if (index == -1) throw std::runtime_error("Port not found: " + port_label);
+
+  if (this->ports[index]->get_port_type() != PortType::OUT)
+    throw std::invalid_argument("Invalid port type, should be an output");
+
+  this->get_output_data(index)->set_pinned(new_state);
+}
+
+bool Node::is_sole_consumer(int port_index) const
+{
+  return this->p_graph &&
+         this->p_graph->is_sole_consumer(this->handle, port_index);
+}
+
+void Node::notify_value_change()
+{
+  // values set by the node itself are outputs of the running update
+  if (this->is_computing || !this->p_graph) return;
+
+  if (this->p_graph->is_reactive()) this->p_graph->request_update(this->id);
+}
+
+void Node::publish_outputs()
+{
+  for (const auto &port : this->ports)
+    if (port->is_double_buffered()) port->publish();
+}
+
+void Node::release_input(int port_index)
+{
+  if (this->p_graph) this->p_graph->release_input(this->handle, port_index);
+}
+
+void Node::update(bool use_caches)
 {
   if (this->is_dirty)
   {
-    this->compute();
+    Graph       *p_cached_graph = use_caches ? this->p_graph : nullptr;
+    ResultCache *p_cache = p_cached_graph ? p_cached_graph->get_result_cache()
+                                          : nullptr;
+    DiskCache   *p_disk_cache = p_cached_graph
+                                    ? p_cached_graph->get_disk_cache()
+                                    : nullptr;
+    std::optional<CacheKey> key;
+
+    // results of a previous computation, from memory and then from disk
+    if (p_cache || p_disk_cache)
+    {
+      key = helper_get_cache_key(*this);
+
+      if (key)
+      {
+        std::vector<std::shared_ptr<BaseData>> outputs = helper_get_outputs(
+            *this);
+
+        bool is_restored = p_cache && p_cache->restore(*key, outputs);
+
+        if (!is_restored && p_disk_cache &&
+            p_disk_cache->restore(*key, outputs))
+        {
+          is_restored = true;
+          if (p_cache) p_cache->store(*key, outputs);
+        }
+
+        if (is_restored)
+        {
+          Logger::log()->trace("Node::update: cache hit for node: {}({})",
+                               this->label,
+                               this->id);
+          this->is_dirty = false;
+          this->publish_outputs();
+          return;
+        }
+      }
+    }
+
+    this->is_compute_interrupted = false;
+    this->is_computing = true;
+
+    try
+    {
+      this->compute();
+    }
+    catch (...)
+    {
+      this->is_computing = false;
+      throw;
+    }
+
+    this->is_computing = false;
+
+    // an interrupted computation leaves the node dirty
+    if (this->is_compute_interrupted) return;
+
     this->is_dirty = false;
+    this->publish_outputs();
+
+    if (key)
+    {
+      std::vector<std::shared_ptr<BaseData>> outputs = helper_get_outputs(
+          *this);
+
+      if (p_cache) p_cache->store(*key, outputs);
+      if (p_disk_cache) p_disk_cache->store(*key, outputs);
+    }
+  }
+}
+
+void Node::update_variants(VariantBatch &batch)
+{
+  std::vector<std::shared_ptr<BaseData>> bound(this->ports.size());
+
+  for (size_t k = 0; k < this->ports.size(); ++k)
+    if (this->ports[k]->get_port_type() == PortType::IN)
+      bound[k] = this->ports[k]->get_data_shared_ptr_downcasted();
+
+  auto unbind = [&]()
+  {
+    for (size_t k = 0; k < this->ports.size(); ++k)
+      if (this->ports[k]->get_port_type() == PortType::IN)
+        this->ports[k]->set_data(bound[k]);
+
+    this->is_computing = false;
+  };
+
+  this->is_compute_interrupted = false;
+  this->is_computing = true;
+
+  try
+  {
+    if (!this->compute_variants(batch))
+      for (size_t variant = 0; variant < batch.get_variant_count(); ++variant)
+      {
+        for (size_t k = 0; k < this->ports.size(); ++k)
+          if (this->ports[k]->get_port_type() == PortType::IN)
+            this->ports[k]->set_data(batch.get_base_data(int(k), variant));
+
+        this->compute();
+
+        for (size_t k = 0; k < this->ports.size(); ++k)
+        {
+          if (this->ports[k]->get_port_type() != PortType::OUT) continue;
+
+          const auto &p_target = batch.get_base_data(int(k), variant);
+
+          if (!p_target ||
+              !p_target->copy_from(
+                  *this->ports[k]->get_data_shared_ptr_downcasted()))
+            throw std::runtime_error(
+                "Node::update_variants: value cannot be copied: " +
+                this->label + ", " + this->ports[k]->get_label());
+        }
+      }
   }
+  catch (...)
+  {
+    unbind();
+    throw;
+  }
+
+  unbind();
 }
 
 } // namespace gnode
@@ -0,0 +1,59 @@
+/* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#include "gnode/parameter_table.hpp"
+
+namespace gnode
+{
+
+std::shared_ptr<BaseData> BatchResult::get_base_data(
+    size_t             variant,
+    const std::string &node_id,
+    const std::string &port_label) const
+{
+  auto it = this->outputs.find({node_id, port_label});
+
+  if (it == this->outputs.end() || variant >= it->second.size())
+    return nullptr;
+
+  return it->second[variant];
+}
+
+std::vector<std::shared_ptr<BaseData>> BatchResult::get_variants(
+    const std::string &node_id,
+    const std::string &port_label) const
+{
+  auto it = this->outputs.find({node_id, port_label});
+  return it == this->outputs.end() ? std::vector<std::shared_ptr<BaseData>>()
+                                   : it->second;
+}
+
+void BatchResult::set_base_data(size_t                    variant,
+                                const std::string        &node_id,
+                                const std::string        &port_label,
+                                std::shared_ptr<BaseData> p_data)
+{
+  if (variant >= this->variant_count)
+    throw std::out_of_range("BatchResult::set_base_data: variant " +
+                            std::to_string(variant) + " out of range");
+
+  auto &values = this->outputs[{node_id, port_label}];
+
+  values.resize(this->variant_count);
+  values[variant] = std::move(p_data);
+}
+
+ParameterColumn &ParameterTable::get_column(const std::string &node_id,
+                                            const std::string &port_label)
+{
+  for (auto &column : this->columns)
+    if (column.node_id == node_id && column.port_label == port_label)
+      return column;
+
+  this->columns.push_back({node_id, port_label, {}});
+  this->columns.back().values.resize(this->variant_count);
+
+  return this->columns.back();
+}
+
+} // namespace gnode
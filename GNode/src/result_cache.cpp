@@ -0,0 +1,139 @@
+/* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#include "gnode/result_cache.hpp"
+
+namespace gnode
+{
+
+uint64_t CacheKey::get_hash() const
+{
+  uint64_t hash = hash_bytes(this->node_label.data(), this->node_label.size());
+
+  hash = hash_bytes(&this->parameters_hash, sizeof(uint64_t), hash);
+  return hash_bytes(this->input_hashes.data(),
+                    this->input_hashes.size() * sizeof(uint64_t),
+                    hash);
+}
+
+void ResultCache::clear()
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+
+  this->entries.clear();
+  this->index.clear();
+  this->stats.entries = 0;
+  this->stats.bytes = 0;
+}
+
+void ResultCache::evict()
+{
+  while (this->stats.bytes > this->byte_budget && !this->entries.empty())
+  {
+    const Entry &entry = this->entries.back();
+
+    this->stats.bytes -= entry.bytes;
+    this->stats.entries--;
+    this->stats.evictions++;
+    this->index.erase(entry.key);
+    this->entries.pop_back();
+  }
+}
+
+size_t ResultCache::get_byte_budget() const
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->byte_budget;
+}
+
+CacheStats ResultCache::get_stats() const
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->stats;
+}
+
+void ResultCache::reset_stats()
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+
+  this->stats.hits = 0;
+  this->stats.misses = 0;
+  this->stats.evictions = 0;
+}
+
+bool ResultCache::restore(const CacheKey                               &key,
+                          const std::vector<std::shared_ptr<BaseData>> &outputs)
+{
+  std::vector<std::shared_ptr<BaseData>> cached;
+
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    auto it = this->index.find(key);
+
+    if (it == this->index.end() || it->second->outputs.size() != outputs.size())
+    {
+      this->stats.misses++;
+      return false;
+    }
+
+    this->entries.splice(this->entries.begin(), this->entries, it->second);
+    this->stats.hits++;
+    cached = it->second->outputs;
+  }
+
+  // the entries are never modified once stored, the copy can be done
+  // without holding the lock
+  for (size_t k = 0; k < outputs.size(); ++k)
+    if (!outputs[k] || !outputs[k]->copy_from(*cached[k])) return false;
+
+  return true;
+}
+
+void ResultCache::set_byte_budget(size_t new_budget)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+
+  this->byte_budget = new_budget;
+  this->evict();
+}
+
+void ResultCache::store(const CacheKey                               &key,
+                        const std::vector<std::shared_ptr<BaseData>> &outputs)
+{
+  Entry entry;
+  entry.key = key;
+  entry.outputs.reserve(outputs.size());
+
+  for (const auto &p_data : outputs)
+  {
+    std::shared_ptr<BaseData> p_copy = p_data ? p_data->clone() : nullptr;
+    if (!p_copy) return;
+
+    entry.bytes += p_copy->get_byte_size();
+    entry.outputs.push_back(std::move(p_copy));
+  }
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+
+  if (entry.bytes > this->byte_budget) return;
+
+  auto it = this->index.find(key);
+
+  if (it != this->index.end())
+  {
+    this->stats.bytes -= it->second->bytes;
+    this->stats.entries--;
+    this->entries.erase(it->second);
+    this->index.erase(it);
+  }
+
+  this->stats.bytes += entry.bytes;
+  this->stats.entries++;
+  this->entries.push_front(std::move(entry));
+  this->index.emplace(key, this->entries.begin());
+
+  this->evict();
+}
+
+} // namespace gnode
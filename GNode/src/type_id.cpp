@@ -0,0 +1,104 @@
+/* Copyright (c) 2023 Otto Link. Distributed under the terms of the GNU General
+ * Public License. The full license is in the file LICENSE, distributed with
+ * this software. */
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <typeindex>
+#include <unordered_map>
+
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#endif
+
+#include "gnode/type_id.hpp"
+
+namespace gnode
+{
+
+struct TypeEntry
+{
+  std::string name;
+  std::string pretty_name; // empty until requested
+};
+
+// registered types, entry k being the type of identifier k + 1 (the entries
+// are never moved, their names being returned by reference)
+struct TypeRegistry
+{
+  std::mutex                                  mutex;
+  std::deque<TypeEntry>                       entries;
+  std::unordered_map<std::type_index, TypeId> ids;
+};
+
+// never destroyed, types being possibly looked up by static objects destroyed
+// at exit
+TypeRegistry &helper_get_type_registry()
+{
+  static TypeRegistry *p_registry = new TypeRegistry();
+  return *p_registry;
+}
+
+std::string helper_demangle(const std::string &name)
+{
+#if __has_include(<cxxabi.h>)
+  int   status = 0;
+  char *p_name = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status);
+
+  if (p_name && status == 0)
+  {
+    std::string demangled(p_name);
+    std::free(p_name);
+    return demangled;
+  }
+
+  std::free(p_name);
+#endif
+
+  return name;
+}
+
+const std::string &get_type_name(TypeId id)
+{
+  static const std::string unknown;
+  TypeRegistry            &registry = helper_get_type_registry();
+
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  if (id == 0 || id > registry.entries.size()) return unknown;
+  return registry.entries[id - 1].name;
+}
+
+const std::string &get_type_pretty_name(TypeId id)
+{
+  static const std::string unknown;
+  TypeRegistry            &registry = helper_get_type_registry();
+
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  if (id == 0 || id > registry.entries.size()) return unknown;
+
+  TypeEntry &entry = registry.entries[id - 1];
+
+  if (entry.pretty_name.empty())
+    entry.pretty_name = helper_demangle(entry.name);
+
+  return entry.pretty_name;
+}
+
+TypeId intern_type(const std::type_info &info)
+{
+  TypeRegistry &registry = helper_get_type_registry();
+
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  auto [it, is_new] = registry.ids.try_emplace(
+      std::type_index(info),
+      static_cast<TypeId>(registry.entries.size() + 1));
+
+  if (is_new) registry.entries.push_back({info.name(), ""});
+
+  return it->second;
+}
+
+} // namespace gnode
@@ -0,0 +1,134 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "nodes.hpp"
+
+class DelayedAdd : public Add
+{
+public:
+  explicit DelayedAdd(std::atomic<int> *p_count) : p_count(p_count) {}
+
+  void compute() override
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    Add::compute();
+    ++(*this->p_count);
+  }
+
+private:
+  std::atomic<int> *p_count;
+};
+
+class Spin : public Add
+{
+public:
+  void compute() override
+  {
+    while (!this->is_cancel_requested())
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+};
+
+// value -> chain of n nodes, each adding the value
+static std::vector<std::string> build_chain(gnode::Graph      &g,
+                                            const std::string &value,
+                                            int                n,
+                                            std::atomic<int>  *p_count)
+{
+  std::vector<std::string> chain;
+  std::string              prev = value;
+
+  for (int i = 0; i < n; ++i)
+  {
+    chain.push_back(g.add_node<DelayedAdd>(p_count));
+    g.new_link(prev, i == 0 ? "value" : "a + b", chain.back(), "a");
+    g.new_link(value, "value", chain.back(), "b");
+    prev = chain.back();
+  }
+
+  return chain;
+}
+
+TEST(GraphAsyncUpdate, Completion)
+{
+  std::atomic<int> count = 0;
+
+  gnode::Graph g;
+  auto         v = g.add_node<Value>(1.f);
+  auto         chain = build_chain(g, v, 5, &count);
+
+  std::atomic<int> callback_count = 0;
+  g.set_update_callback([&](const std::string &,
+                            const std::vector<std::string> &,
+                            bool) { callback_count++; });
+
+  auto done = g.update_async(v);
+  EXPECT_TRUE(done.get());
+  EXPECT_EQ(count.load(), 5);
+  EXPECT_EQ(callback_count.load(), 2 * 6);
+  EXPECT_FLOAT_EQ(
+      *g.get_node_ref_by_id(chain.back())->get_value_ref<float>("a + b"),
+      6.f);
+}
+
+TEST(GraphAsyncUpdate, PreemptionReusesResults)
+{
+  std::atomic<int> count1 = 0;
+  std::atomic<int> count2 = 0;
+
+  gnode::Graph g;
+  auto         v1 = g.add_node<Value>(1.f);
+  auto         v2 = g.add_node<Value>(1.f);
+  auto         chain1 = build_chain(g, v1, 20, &count1);
+  auto         chain2 = build_chain(g, v2, 5, &count2);
+
+  g.update();
+  count1 = 0;
+  count2 = 0;
+
+  // start a long update, then preempt it once a few nodes are done
+  g.get_node_ref_by_id(v1)->set_value<float>("value", 2.f);
+  auto first = g.update_async(v1);
+
+  while (count1.load() < 3)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  auto second = g.update_async(v2);
+
+  EXPECT_FALSE(first.get());
+  EXPECT_TRUE(second.get());
+
+  // the nodes updated before the preemption are not updated again
+  EXPECT_EQ(count1.load(), 20);
+  EXPECT_EQ(count2.load(), 5);
+  EXPECT_FLOAT_EQ(
+      *g.get_node_ref_by_id(chain1.back())->get_value_ref<float>("a + b"),
+      42.f);
+
+  for (const auto &[_, p_node] : g.get_nodes())
+    EXPECT_FALSE(p_node->is_dirty);
+}
+
+TEST(GraphAsyncUpdate, CancelLongCompute)
+{
+  gnode::Graph g;
+
+  auto v = g.add_node<Value>(1.f);
+  auto spin = g.add_node<Spin>();
+  auto add = g.add_node<Add>();
+
+  g.new_link(v, "value", spin, "a");
+  g.new_link(spin, "a + b", add, "a");
+
+  auto done = g.update_async(v);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  g.cancel_update();
+
+  EXPECT_FALSE(done.get());
+  EXPECT_TRUE(g.get_node_ref_by_id(spin)->is_dirty);
+  EXPECT_TRUE(g.get_node_ref_by_id(add)->is_dirty);
+}
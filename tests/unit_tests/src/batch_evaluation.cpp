@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+
+#include "nodes.hpp"
+
+// Add computing all the variants at once, counting its calls
+class VariantAdd : public Add
+{
+public:
+  explicit VariantAdd(int *p_count) : p_count(p_count) {}
+
+  bool compute_variants(gnode::VariantBatch &batch) override
+  {
+    for (size_t v = 0; v < batch.get_variant_count(); ++v)
+      *batch.get_value_ref<float>(2, v) = *batch.get_value_ref<float>(0, v) +
+                                          *batch.get_value_ref<float>(1, v);
+
+    ++(*this->p_count);
+    return true;
+  }
+
+private:
+  int *p_count;
+};
+
+// (x + y) + z, only x and z being overridden
+struct Sweep
+{
+  Sweep()
+  {
+    x = g.add_node<Value>(1.f);
+    y = g.add_node<Value>(10.f);
+    z = g.add_node<Value>(100.f);
+    s1 = g.add_node<CountingAdd>(&count_s1);
+    s2 = g.add_node<CountingAdd>(&count_s2);
+
+    g.new_link(x, "value", s1, "a");
+    g.new_link(y, "value", s1, "b");
+    g.new_link(s1, "a + b", s2, "a");
+    g.new_link(z, "value", s2, "b");
+  }
+
+  gnode::Graph g;
+  std::string  x, y, z, s1, s2;
+  int          count_s1 = 0;
+  int          count_s2 = 0;
+};
+
+TEST(GraphBatchEvaluation, Variants)
+{
+  Sweep                 sweep;
+  gnode::ParameterTable table(4);
+
+  for (size_t k = 0; k < 4; ++k)
+    table.set_value<float>(k, sweep.x, "value", float(k));
+
+  // z only overridden for the last variant
+  table.set_value<float>(3, sweep.z, "value", 1000.f);
+
+  gnode::BatchResult result = sweep.g.evaluate_batch(table, {sweep.s2});
+
+  ASSERT_EQ(result.get_variant_count(), 4u);
+  EXPECT_FLOAT_EQ(*result.get_value_ref<float>(0, sweep.s2, "a + b"), 110.f);
+  EXPECT_FLOAT_EQ(*result.get_value_ref<float>(1, sweep.s2, "a + b"), 111.f);
+  EXPECT_FLOAT_EQ(*result.get_value_ref<float>(2, sweep.s2, "a + b"), 112.f);
+  EXPECT_FLOAT_EQ(*result.get_value_ref<float>(3, sweep.s2, "a + b"), 1013.f);
+  EXPECT_EQ(result.get_variants(sweep.s2, "a + b").size(), 4u);
+
+  // once per variant
+  EXPECT_EQ(sweep.count_s1, 4);
+  EXPECT_EQ(sweep.count_s2, 4);
+
+  // not requested, type mismatch
+  EXPECT_FALSE(result.get_value_ref<float>(0, sweep.s1, "a + b"));
+  EXPECT_FALSE(result.get_value_ref<int>(0, sweep.s2, "a + b"));
+
+  // graph values restored
+  auto *p_s2 = sweep.g.get_node_ref_by_id(sweep.s2);
+
+  EXPECT_FLOAT_EQ(*sweep.g.get_node_ref_by_id(sweep.x)->get_value_ref<float>(
+                      "value"),
+                  1.f);
+  EXPECT_TRUE(p_s2->is_dirty);
+
+  sweep.g.evaluate(std::vector<std::string>{sweep.s2});
+  EXPECT_FLOAT_EQ(*p_s2->get_value_ref<float>("a + b"), 111.f);
+}
+
+TEST(GraphBatchEvaluation, VariantBatch)
+{
+  Sweep sweep;
+  int   count = 0;
+
+  // (x + y) + z + w, the last node getting all the variants at once
+  auto w = sweep.g.add_node<Value>(1000.f);
+  auto s3 = sweep.g.add_node<VariantAdd>(&count);
+
+  sweep.g.new_link(sweep.s2, "a + b", s3, "a");
+  sweep.g.new_link(w, "value", s3, "b");
+
+  gnode::ParameterTable table(3);
+
+  for (size_t k = 0; k < 3; ++k)
+    table.set_value<float>(k, sweep.x, "value", float(k));
+
+  gnode::BatchResult result = sweep.g.evaluate_batch(table, {s3, sweep.x});
+
+  for (size_t k = 0; k < 3; ++k)
+  {
+    EXPECT_FLOAT_EQ(*result.get_value_ref<float>(k, s3, "a + b"),
+                    1110.f + float(k));
+    EXPECT_FLOAT_EQ(*result.get_value_ref<float>(k, sweep.x, "value"),
+                    float(k));
+  }
+
+  // a single call for all the variants, one computation per variant
+  // otherwise
+  EXPECT_EQ(count, 1);
+  EXPECT_EQ(sweep.count_s2, 3);
+
+  // overridden values never written to the graph
+  EXPECT_FLOAT_EQ(*sweep.g.get_node_ref_by_id(sweep.x)->get_value_ref<float>(
+                      "value"),
+                  1.f);
+}
+
+TEST(GraphBatchEvaluation, Errors)
+{
+  Sweep                 sweep;
+  gnode::ParameterTable table(2);
+
+  EXPECT_THROW(table.set_value<float>(2, sweep.x, "value", 0.f),
+               std::out_of_range);
+
+  table.set_value<int>(0, sweep.x, "value", 1);
+  EXPECT_THROW(sweep.g.evaluate_batch(table, {sweep.s2}), std::runtime_error);
+
+  gnode::ParameterTable unknown(1);
+
+  unknown.set_value<float>(0, "missing", "value", 1.f);
+  EXPECT_THROW(sweep.g.evaluate_batch(unknown, {sweep.s2}), std::runtime_error);
+
+  // nothing computed
+  EXPECT_EQ(sweep.count_s2, 0);
+}
@@ -0,0 +1,95 @@
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+#include "nodes.hpp"
+
+// records the memory used by the graph outputs when computed
+class Stage : public gnode::Node
+{
+public:
+  explicit Stage(size_t *p_peak) : gnode::Node("Stage"), p_peak(p_peak)
+  {
+    add_port<Buffer>(gnode::PortType::IN, "in1");
+    add_port<Buffer>(gnode::PortType::IN, "in2");
+    add_port<Buffer>(gnode::PortType::OUT, "out");
+  }
+
+  void compute() override
+  {
+    auto *in1 = get_value_ref<Buffer>("in1");
+    auto *in2 = get_value_ref<Buffer>("in2");
+    auto *out = get_value_ref<Buffer>("out");
+
+    out->assign(buffer_size, 1.f);
+
+    for (size_t k = 0; k < buffer_size; ++k)
+      (*out)[k] += (in1 ? (*in1)[k] : 0.f) + (in2 ? (*in2)[k] : 0.f);
+
+    *this->p_peak = std::max(*this->p_peak,
+                             this->get_p_graph()->get_memory_usage());
+  }
+
+private:
+  size_t *p_peak;
+};
+
+// source -> 8 stages, each stage also reading the source
+static std::vector<std::string> build_pipeline(gnode::Graph &g, size_t *p_peak)
+{
+  std::vector<std::string> ids = {g.add_node<Stage>(p_peak)};
+
+  for (int i = 0; i < 8; ++i)
+  {
+    ids.push_back(g.add_node<Stage>(p_peak));
+    g.new_link(ids[i], "out", ids.back(), "in1");
+    g.new_link(ids[0], "out", ids.back(), "in2");
+  }
+
+  return ids;
+}
+
+TEST(GraphBatchMode, PeakMemory)
+{
+  size_t peak = 0;
+
+  {
+    gnode::Graph g;
+    auto         ids = build_pipeline(g, &peak);
+    g.update();
+    EXPECT_EQ(peak, ids.size() * buffer_bytes);
+  }
+
+  peak = 0;
+
+  gnode::Graph g;
+  auto         ids = build_pipeline(g, &peak);
+  g.set_batch_mode(true);
+  g.update();
+
+  // source, input and output of the running stage, along with the empty
+  // outputs of the stages not computed yet
+  EXPECT_LE(peak, 3 * buffer_bytes + ids.size() * sizeof(Buffer));
+  EXPECT_FLOAT_EQ(first_value(g, ids.back()), 17.f);
+  EXPECT_EQ(g.get_memory_usage(), buffer_bytes);
+
+  // released outputs are recomputed on access
+  EXPECT_FLOAT_EQ(first_value(g, ids[1]), 3.f);
+}
+
+TEST(GraphBatchMode, PinnedAndParallel)
+{
+  size_t peak = 0;
+
+  gnode::Graph g;
+  auto         ids = build_pipeline(g, &peak);
+
+  g.get_node_ref_by_id(ids[4])->set_output_pinned("out");
+  g.set_batch_mode(true);
+  g.set_executor(std::make_shared<gnode::ThreadPoolExecutor>(4));
+  g.update();
+
+  EXPECT_EQ(g.get_memory_usage(), 2 * buffer_bytes);
+  EXPECT_EQ(residency(g, ids[4]), gnode::DataResidency::RESIDENT);
+  EXPECT_FLOAT_EQ(first_value(g, ids.back()), 1.f + 8.f * 2.f);
+}
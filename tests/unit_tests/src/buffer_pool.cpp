@@ -0,0 +1,109 @@
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include "nodes.hpp"
+
+static bool is_aligned(const void *p, size_t alignment)
+{
+  return reinterpret_cast<uintptr_t>(p) % alignment == 0;
+}
+
+TEST(BufferPool, SizeClasses)
+{
+  EXPECT_EQ(gnode::BufferPool::get_class_size(1), 64u);
+  EXPECT_EQ(gnode::BufferPool::get_class_size(65), 128u);
+  EXPECT_EQ(gnode::BufferPool::get_class_size(4096), 4096u);
+  EXPECT_EQ(gnode::BufferPool::get_class_size(4097), 5120u);
+  EXPECT_EQ(gnode::BufferPool::get_class_size(40000), 40960u);
+
+  for (size_t bytes = 1; bytes < (1 << 20); bytes = bytes * 3 / 2 + 1)
+  {
+    const size_t size = gnode::BufferPool::get_class_size(bytes);
+
+    EXPECT_GE(size, bytes);
+    EXPECT_LE(size, 2 * bytes + 64);
+    EXPECT_EQ(size % gnode::BufferPool::alignment, 0u);
+  }
+}
+
+TEST(BufferPool, Reuse)
+{
+  gnode::BufferPool pool(1 << 20);
+
+  void *p = pool.allocate(40000);
+  EXPECT_TRUE(is_aligned(p, gnode::BufferPool::alignment));
+  pool.deallocate(p, 40000);
+
+  // same size class, served from the free list
+  void *q = pool.allocate(39000);
+  EXPECT_EQ(q, p);
+  EXPECT_EQ(pool.get_stats().reuses, 1u);
+  EXPECT_EQ(pool.get_stats().bytes_in_use, 40960u);
+
+  pool.deallocate(q, 39000);
+  EXPECT_EQ(pool.get_stats().bytes_cached, 40960u);
+
+  pool.trim();
+  EXPECT_EQ(pool.get_stats().bytes_cached, 0u);
+
+  // beyond the cache limit, blocks are released right away
+  pool.set_cache_limit(0);
+  pool.deallocate(pool.allocate(100), 100);
+  EXPECT_EQ(pool.get_stats().bytes_cached, 0u);
+  EXPECT_EQ(pool.get_stats().bytes_in_use, 0u);
+}
+
+TEST(BufferPool, HugePages)
+{
+  gnode::BufferPool pool;
+  pool.set_huge_pages(true);
+
+  const size_t bytes = 3 * gnode::BufferPool::huge_page_size;
+  void        *p = pool.allocate(bytes);
+
+#ifdef __linux__
+  EXPECT_TRUE(is_aligned(p, gnode::BufferPool::huge_page_size));
+#endif
+
+  static_cast<char *>(p)[bytes - 1] = 1;
+  pool.deallocate(p, bytes);
+}
+
+TEST(BufferPool, PooledData)
+{
+  using Buffer = gnode::PooledVector<float>;
+
+  gnode::Graph g;
+  auto         id = g.add_node<Value>(1.f);
+  auto        *p_node = g.get_node_ref_by_id(id);
+
+  p_node->add_port<Buffer>(gnode::PortType::OUT, "buffer", 1000, 1.f);
+  p_node->add_port<float>(gnode::PortType::OUT, "other");
+
+  // SIMD alignment of the elements
+  Buffer *p_buffer = p_node->get_value_ref<Buffer>("buffer");
+  EXPECT_TRUE(is_aligned(p_buffer->data(), gnode::BufferPool::alignment));
+
+  // outputs in different cache lines
+  auto line_range = [&](const std::string &port_label)
+  {
+    auto p = reinterpret_cast<uintptr_t>(
+        p_node->get_base_data(port_label).get());
+    return std::make_pair(p / gnode::BufferPool::alignment,
+                          (p + sizeof(gnode::Data<float>) - 1) /
+                              gnode::BufferPool::alignment);
+  };
+
+  auto [a_first, a_last] = line_range("value");
+  auto [b_first, b_last] = line_range("other");
+  EXPECT_TRUE(a_last < b_first || b_last < a_first);
+
+  // the buffers are hashed, sized and copied as other vectors
+  EXPECT_EQ(p_node->get_base_data("buffer")->get_byte_size(),
+            sizeof(Buffer) + 1000 * sizeof(float));
+  EXPECT_TRUE(p_node->get_base_data("buffer")->get_hash().has_value());
+
+  auto p_copy = p_node->get_base_data("buffer")->clone();
+  EXPECT_FLOAT_EQ(static_cast<Buffer *>(p_copy->get_value_ptr())->at(999), 1.f);
+}
@@ -0,0 +1,36 @@
+#include <gtest/gtest.h>
+
+#include "nodes.hpp"
+
+TEST(GraphConnectivity, AdjacencyFollowsEdits)
+{
+  gnode::Graph g;
+
+  auto v = g.add_node<Value>(1.f);
+  auto a1 = g.add_node<Add>();
+  auto a2 = g.add_node<Add>();
+
+  g.new_link(v, "value", a1, "a");
+  g.new_link(v, "value", a1, "b");
+  g.new_link(a1, "a + b", a2, "a");
+
+  EXPECT_EQ(g.get_links_downstream(v).size(), 2u);
+  EXPECT_EQ(g.get_links_upstream(a1).size(), 2u);
+  EXPECT_EQ(g.get_connectivity_upstream(a2),
+            std::vector<std::string>({a1}));
+  EXPECT_TRUE(g.get_node_ref_by_id(a1)->is_port_connected("a + b"));
+
+  g.remove_link(v, "value", a1, "b");
+
+  EXPECT_EQ(g.get_links_downstream(v).size(), 1u);
+  EXPECT_EQ(g.get_links_upstream(a1).size(), 1u);
+
+  g.remove_node(a1);
+
+  EXPECT_TRUE(g.get_links_downstream(v).empty());
+  EXPECT_TRUE(g.get_links_upstream(a2).empty());
+  EXPECT_TRUE(g.get_links_downstream(a1).empty());
+  EXPECT_TRUE(g.get_links().empty());
+  EXPECT_FALSE(g.get_node_ref_by_id(v)->is_port_connected("value"));
+  EXPECT_EQ(g.get_link_views(a2).size(), 0u);
+}
@@ -1,3 +1,5 @@
+#include <random>
+
 #include <gtest/gtest.h>
 
 #include "nodes.hpp"
@@ -18,19 +20,21 @@ TEST(GraphCycle, Reachability)
   EXPECT_FALSE(g.is_reachable(add2, add1));
 }
 
-TEST(GraphCycle, DetectSimpleCycle)
+TEST(GraphCycle, RejectSimpleCycle)
 {
   gnode::Graph g;
 
   auto a = g.add_node<Add>();
 
-  g.new_link(a, "a + b", a, "a");
-  g.new_link(a, "a + b", a, "b");
+  EXPECT_FALSE(g.new_link(a, "a + b", a, "a"));
+  EXPECT_FALSE(g.new_link(a, "a + b", a, "b"));
 
-  EXPECT_TRUE(g.has_cycle());
+  EXPECT_TRUE(g.get_links().empty());
+  EXPECT_FALSE(g.get_node_ref_by_id(a)->is_port_connected("a"));
+  EXPECT_FALSE(g.has_cycle());
 }
 
-TEST(GraphCycle, DetectIndirectCycle)
+TEST(GraphCycle, RejectIndirectCycle)
 {
   gnode::Graph g;
 
@@ -41,8 +45,54 @@ TEST(GraphCycle, DetectIndirectCycle)
   g.new_link(a, "value", b, "a");
   g.new_link(b, "a + b", c, "a");
 
-  // create indirect cycle: c -> b
-  g.new_link(c, "a + b", b, "a");
+  // indirect cycle: c -> b
+  EXPECT_FALSE(g.new_link(c, "a + b", b, "b"));
+
+  EXPECT_EQ(g.get_links().size(), 2u);
+  EXPECT_FALSE(g.has_cycle());
+}
+
+TEST(GraphCycle, IncrementalOrderRandomLinks)
+{
+  gnode::Graph g;
+
+  constexpr int N = 200;
+
+  std::vector<std::string> ids;
+  for (int i = 0; i < N; ++i)
+    ids.push_back(g.add_node<Add>());
+
+  std::mt19937                       rng(7);
+  std::uniform_int_distribution<int> dist(0, N - 1);
+
+  for (int k = 0; k < 2000; ++k)
+  {
+    const std::string &from = ids[dist(rng)];
+    const std::string &to = ids[dist(rng)];
+    const std::string  port_to = (k % 2) ? "a" : "b";
+
+    bool creates_cycle = g.is_reachable(to, from);
+    bool exists = false;
+
+    for (const auto &link : g.get_links_downstream(from))
+      exists |= (link.to == to &&
+                 link.port_to ==
+                     g.get_node_ref_by_id(to)->get_port_index(port_to));
+
+    EXPECT_EQ(g.new_link(from, "a + b", to, port_to),
+              !creates_cycle && !exists);
+  }
+
+  // every link must go forward in the topological order
+  const auto &order = g.get_topological_order();
+  ASSERT_EQ(order.size(), static_cast<size_t>(N));
+
+  std::map<std::string, size_t> position;
+  for (size_t k = 0; k < order.size(); ++k)
+    position[order[k]] = k;
+
+  for (const auto &link : g.get_links())
+    EXPECT_LT(position.at(link.from), position.at(link.to));
 
-  EXPECT_TRUE(g.has_cycle());
+  EXPECT_FALSE(g.has_cycle());
 }
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include "nodes.hpp"
+
+// v -> a1 -> s1
+//   -> a2 -> s2, with v also feeding the 'b' ports
+struct TwoBranches
+{
+  TwoBranches()
+  {
+    v = g.add_node<Value>(1.f);
+    a1 = g.add_node<CountingAdd>(&count_a1);
+    s1 = g.add_node<CountingAdd>(&count_s1);
+    a2 = g.add_node<CountingAdd>(&count_a2);
+    s2 = g.add_node<CountingAdd>(&count_s2);
+
+    g.new_link(v, "value", a1, "a");
+    g.new_link(a1, "a + b", s1, "a");
+    g.new_link(v, "value", a2, "a");
+    g.new_link(a2, "a + b", s2, "a");
+
+    for (const auto &id : {a1, s1, a2, s2})
+      g.new_link(v, "value", id, "b");
+
+    g.update();
+    count_a1 = count_s1 = count_a2 = count_s2 = 0;
+  }
+
+  bool is_dirty(const std::string &id)
+  {
+    return g.get_node_ref_by_id(id)->is_dirty;
+  }
+
+  float output(const std::string &id)
+  {
+    return *g.get_node_ref_by_id(id)->get_value_ref<float>("a + b");
+  }
+
+  gnode::Graph g;
+  std::string  v, a1, s1, a2, s2;
+  int          count_a1 = 0, count_s1 = 0, count_a2 = 0, count_s2 = 0;
+};
+
+TEST(GraphDemandEvaluation, OnlyRequestedCone)
+{
+  TwoBranches t;
+
+  t.g.get_node_ref_by_id(t.v)->set_value<float>("value", 2.f);
+  t.g.mark_dirty(t.v);
+
+  for (const auto &id : {t.v, t.a1, t.s1, t.a2, t.s2})
+    EXPECT_TRUE(t.is_dirty(id));
+
+  t.g.evaluate({t.s1});
+
+  EXPECT_EQ(t.count_a1, 1);
+  EXPECT_EQ(t.count_s1, 1);
+  EXPECT_EQ(t.count_a2, 0);
+  EXPECT_EQ(t.count_s2, 0);
+  EXPECT_FLOAT_EQ(t.output(t.s1), 6.f);
+  EXPECT_FLOAT_EQ(t.output(t.s2), 3.f);
+  EXPECT_TRUE(t.is_dirty(t.a2));
+  EXPECT_TRUE(t.is_dirty(t.s2));
+
+  // the other branch is computed on demand, the clean value is reused
+  t.g.evaluate(t.s2, "a + b");
+
+  EXPECT_EQ(t.count_a1, 1);
+  EXPECT_EQ(t.count_s1, 1);
+  EXPECT_EQ(t.count_a2, 1);
+  EXPECT_EQ(t.count_s2, 1);
+  EXPECT_FLOAT_EQ(t.output(t.s2), 6.f);
+
+  // nothing left to compute
+  t.g.evaluate({t.s1, t.s2});
+  EXPECT_EQ(t.count_s1 + t.count_s2, 2);
+
+  EXPECT_THROW(t.g.mark_dirty("unknown"), std::runtime_error);
+  EXPECT_THROW(t.g.evaluate("unknown", "a"), std::runtime_error);
+}
+
+TEST(GraphDemandEvaluation, InputPort)
+{
+  TwoBranches t;
+
+  t.g.mark_dirty(t.a1);
+  t.g.evaluate(t.s1, "a");
+
+  // the node feeding the port is computed, not the node itself
+  EXPECT_EQ(t.count_a1, 1);
+  EXPECT_EQ(t.count_s1, 0);
+  EXPECT_FALSE(t.is_dirty(t.a1));
+  EXPECT_TRUE(t.is_dirty(t.s1));
+  EXPECT_FALSE(t.is_dirty(t.a2));
+}
+
+TEST(GraphDemandEvaluation, StaleNodesAreFlagged)
+{
+  TwoBranches t;
+
+  // the change is not propagated before the evaluation
+  t.g.get_node_ref_by_id(t.v)->is_dirty = true;
+  t.g.evaluate({t.s1});
+
+  EXPECT_EQ(t.count_s1, 1);
+  EXPECT_EQ(t.count_a2, 0);
+  EXPECT_FALSE(t.is_dirty(t.v));
+  EXPECT_TRUE(t.is_dirty(t.a2));
+  EXPECT_TRUE(t.is_dirty(t.s2));
+}
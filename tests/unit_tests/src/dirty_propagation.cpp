@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include "nodes.hpp"
+
+static void check_order(const gnode::Graph             &g,
+                        const std::vector<std::string> &sorted)
+{
+  std::map<std::string, size_t> position;
+  for (size_t k = 0; k < sorted.size(); ++k)
+    position[sorted[k]] = k;
+
+  for (const auto &link : g.get_links())
+  {
+    if (!position.contains(link.from) || !position.contains(link.to)) continue;
+    EXPECT_LT(position.at(link.from), position.at(link.to));
+  }
+}
+
+TEST(GraphStress, DeepChain50000Nodes)
+{
+  gnode::Graph g;
+
+  constexpr int N = 50000;
+
+  auto root = g.add_node<Value>(1.f);
+
+  std::vector<std::string> adds;
+
+  for (int i = 0; i < N; ++i)
+    adds.push_back(g.add_node<Add>());
+
+  g.new_link(root, "value", adds[0], "a");
+  g.new_link(root, "value", adds[0], "b");
+
+  for (int i = 1; i < N; ++i)
+  {
+    g.new_link(adds[i - 1], "a + b", adds[i], "a");
+    g.new_link(root, "value", adds[i], "b");
+  }
+
+  g.update();
+
+  // dirty cone from the middle of the chain
+  auto sorted = g.get_nodes_to_update(adds[N / 2]);
+  ASSERT_EQ(sorted.size(), static_cast<size_t>(N - N / 2));
+  EXPECT_EQ(sorted.front(), adds[N / 2]);
+  EXPECT_EQ(sorted.back(), adds.back());
+
+  g.get_node_ref_by_id<Value>(root)->set_value<float>("value", 2.f);
+  EXPECT_NO_THROW(g.update(root));
+
+  float result = *g.get_node_ref_by_id<Add>(adds.back())
+                      ->get_value_ref<float>("a + b");
+  EXPECT_FLOAT_EQ(result, 2.f * (N + 1));
+}
+
+TEST(GraphStress, WideFanOutFanIn)
+{
+  gnode::Graph g;
+
+  constexpr int W = 20000;
+
+  auto root = g.add_node<Value>(1.f);
+
+  // root -> W parallel adds -> pairwise reduction tree
+  std::vector<std::string> level;
+
+  for (int i = 0; i < W; ++i)
+  {
+    auto id = g.add_node<Add>();
+    g.new_link(root, "value", id, "a");
+    g.new_link(root, "value", id, "b");
+    level.push_back(id);
+  }
+
+  const std::string first = level.front();
+
+  while (level.size() > 1)
+  {
+    std::vector<std::string> next;
+
+    for (size_t k = 0; k + 1 < level.size(); k += 2)
+    {
+      auto id = g.add_node<Add>();
+      g.new_link(level[k], "a + b", id, "a");
+      g.new_link(level[k + 1], "a + b", id, "b");
+      next.push_back(id);
+    }
+
+    if (level.size() % 2) next.push_back(level.back());
+    level = next;
+  }
+
+  auto sorted = g.get_nodes_to_update(root);
+  EXPECT_EQ(sorted.size(), g.get_nodes().size());
+  check_order(g, sorted);
+
+  // public sort of an arbitrary subset, duplicates included
+  std::vector<std::string> subset = {first, root, first};
+  auto                     sorted_subset = g.topological_sort(subset);
+  EXPECT_EQ(sorted_subset, std::vector<std::string>({root, first}));
+
+  g.update(root);
+
+  float result = *g.get_node_ref_by_id<Add>(level[0])->get_value_ref<float>(
+      "a + b");
+  EXPECT_FLOAT_EQ(result, 2.f * W);
+}
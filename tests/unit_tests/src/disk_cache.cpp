@@ -0,0 +1,227 @@
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "nodes.hpp"
+
+namespace fs = std::filesystem;
+
+class Ramp : public gnode::Node
+{
+public:
+  explicit Ramp(int *p_count) : gnode::Node("Ramp"), p_count(p_count)
+  {
+    add_port<float>(gnode::PortType::IN, "slope");
+    add_port<std::vector<float>>(gnode::PortType::OUT, "out");
+  }
+
+  void compute() override
+  {
+    auto *slope = get_value_ref<float>("slope");
+    auto *out = get_value_ref<std::vector<float>>("out");
+
+    out->resize(this->size);
+    for (size_t k = 0; k < out->size(); ++k)
+      (*out)[k] = (slope ? *slope : 1.f) * k;
+
+    ++(*this->p_count);
+  }
+
+  std::optional<uint64_t> get_parameters_hash() const override
+  {
+    return gnode::hash_bytes(&this->size, sizeof(size_t));
+  }
+
+  size_t size = 100;
+
+private:
+  int *p_count;
+};
+
+struct TempDirectory
+{
+  TempDirectory()
+  {
+    std::random_device rd;
+    path = fs::temp_directory_path() /
+           ("gnode_disk_cache_" + std::to_string(rd()));
+  }
+
+  ~TempDirectory() { fs::remove_all(path); }
+
+  fs::path path;
+};
+
+// value -> ramp, as a project reloaded at each run
+static std::string build_project(gnode::Graph &g, int *p_count)
+{
+  auto v = g.add_node<Value>(2.f);
+  auto r = g.add_node<Ramp>(p_count);
+  g.new_link(v, "value", r, "slope");
+  return r;
+}
+
+TEST(GraphDiskCache, RestoreAcrossRuns)
+{
+  TempDirectory dir;
+  int           count = 0;
+
+  {
+    gnode::Graph g;
+    g.set_disk_cache(std::make_shared<gnode::DiskCache>(dir.path));
+    build_project(g, &count);
+    g.update();
+
+    EXPECT_EQ(count, 1);
+    EXPECT_EQ(g.get_disk_cache()->get_stats().entries, 1u);
+  }
+
+  // new run
+  gnode::Graph g;
+  auto         p_cache = std::make_shared<gnode::DiskCache>(dir.path);
+  g.set_disk_cache(p_cache);
+
+  EXPECT_EQ(p_cache->get_stats().entries, 1u);
+
+  auto r = build_project(g, &count);
+  g.update();
+
+  EXPECT_EQ(count, 1);
+  EXPECT_EQ(p_cache->get_stats().hits, 1u);
+  EXPECT_FLOAT_EQ(
+      g.get_node_ref_by_id(r)->get_value_ref<std::vector<float>>("out")->at(3),
+      6.f);
+
+  // different parameters
+  g.get_node_ref_by_id<Ramp>(r)->size = 10;
+  g.update(r);
+  EXPECT_EQ(count, 2);
+  EXPECT_EQ(p_cache->get_stats().entries, 2u);
+}
+
+TEST(GraphDiskCache, CrashSafety)
+{
+  TempDirectory dir;
+  int           count = 0;
+
+  {
+    gnode::Graph g;
+    g.set_disk_cache(std::make_shared<gnode::DiskCache>(dir.path));
+    build_project(g, &count);
+    g.update();
+  }
+
+  // leftover of an interrupted write and truncated entry
+  std::ofstream(dir.path / "123_0.tmp") << "partial";
+
+  for (const auto &item : fs::directory_iterator(dir.path))
+    if (item.path().extension() == ".gnc") fs::resize_file(item.path(), 20);
+
+  gnode::Graph g;
+  auto         p_cache = std::make_shared<gnode::DiskCache>(dir.path);
+  g.set_disk_cache(p_cache);
+
+  EXPECT_FALSE(fs::exists(dir.path / "123_0.tmp"));
+
+  // the truncated entry is replaced
+  build_project(g, &count);
+  g.update();
+
+  EXPECT_EQ(count, 2);
+  EXPECT_EQ(p_cache->get_stats().misses, 1u);
+  EXPECT_EQ(p_cache->get_stats().entries, 1u);
+}
+
+TEST(GraphDiskCache, CorruptedSize)
+{
+  TempDirectory dir;
+  int           count = 0;
+
+  {
+    gnode::Graph g;
+    g.set_disk_cache(std::make_shared<gnode::DiskCache>(dir.path));
+    build_project(g, &count);
+    g.update();
+  }
+
+  // the vector size, stored right before its 100 elements, is overwritten
+  for (const auto &item : fs::directory_iterator(dir.path))
+    if (item.path().extension() == ".gnc")
+    {
+      std::fstream   f(item.path(), std::ios::binary | std::ios::in |
+                                        std::ios::out);
+      const uint64_t size = uint64_t(1) << 40;
+
+      f.seekp(-static_cast<std::streamoff>(100 * sizeof(float) +
+                                           sizeof(uint64_t)),
+              std::ios::end);
+      f.write(reinterpret_cast<const char *>(&size), sizeof(uint64_t));
+    }
+
+  gnode::Graph g;
+  auto         p_cache = std::make_shared<gnode::DiskCache>(dir.path);
+  g.set_disk_cache(p_cache);
+
+  // a cache miss, the entry being replaced
+  auto r = build_project(g, &count);
+  EXPECT_NO_THROW(g.update());
+
+  EXPECT_EQ(count, 2);
+  EXPECT_EQ(p_cache->get_stats().misses, 1u);
+  EXPECT_EQ(p_cache->get_stats().entries, 1u);
+  EXPECT_EQ(
+      g.get_node_ref_by_id(r)->get_value_ref<std::vector<float>>("out")->size(),
+      100u);
+}
+
+TEST(GraphDiskCache, SizeLimit)
+{
+  TempDirectory dir;
+
+  gnode::DiskCache cache(dir.path);
+  auto             p_data = std::make_shared<gnode::Data<std::vector<float>>>(
+      1000,
+      1.f);
+  gnode::CacheKey  key{"Ramp", 0, {}};
+
+  cache.store(key, {p_data});
+  const size_t entry_size = cache.get_stats().bytes;
+  EXPECT_GT(entry_size, 1000 * sizeof(float));
+
+  cache.set_byte_limit(2 * entry_size);
+
+  for (uint64_t k = 1; k < 4; ++k)
+  {
+    key.parameters_hash = k;
+    cache.store(key, {p_data});
+  }
+
+  EXPECT_EQ(cache.get_stats().entries, 2u);
+  EXPECT_EQ(cache.get_stats().evictions, 2u);
+
+  size_t files = 0;
+  for (const auto &item : fs::directory_iterator(dir.path))
+    files += item.path().extension() == ".gnc";
+  EXPECT_EQ(files, 2u);
+
+  // data without serialization is not stored
+  struct Opaque
+  {
+    std::vector<int> values;
+  };
+
+  key.parameters_hash = 10;
+  cache.store(key, {std::make_shared<gnode::Data<Opaque>>()});
+  EXPECT_EQ(cache.get_stats().entries, 2u);
+
+  // nor are addresses, which would dangle in the next run
+  key.parameters_hash = 11;
+  cache.store(key, {std::make_shared<gnode::Data<float *>>()});
+  cache.store(key, {std::make_shared<gnode::Data<std::vector<float *>>>()});
+  EXPECT_EQ(cache.get_stats().entries, 2u);
+
+  cache.clear();
+  EXPECT_TRUE(fs::is_empty(dir.path));
+}
@@ -0,0 +1,102 @@
+#include <atomic>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "nodes.hpp"
+
+// fills its output, element by element, with the update count
+class Counter : public gnode::Node
+{
+public:
+  Counter() : gnode::Node("Counter")
+  {
+    add_port<Buffer>(gnode::PortType::OUT, "out", 10000, 0.f);
+    set_output_double_buffered("out");
+  }
+
+  void compute() override
+  {
+    ++this->count;
+    for (auto &v : *get_value_ref<Buffer>("out"))
+      v = this->count;
+  }
+
+  float count = 0.f;
+};
+
+TEST(NodeDoubleBuffer, Publish)
+{
+  gnode::Graph g;
+  auto         id = g.add_node<Counter>();
+  auto        *p_node = g.get_node_ref_by_id(id);
+
+  EXPECT_FALSE(p_node->get_snapshot<Buffer>("out").value);
+
+  g.update();
+  auto s1 = p_node->get_snapshot<Buffer>("out");
+
+  ASSERT_TRUE(s1.value);
+  EXPECT_EQ(s1.version, 1u);
+  EXPECT_FLOAT_EQ(s1.value->at(0), 1.f);
+
+  // a snapshot is stable across updates
+  g.update();
+  auto s2 = p_node->get_snapshot<Buffer>("out");
+
+  EXPECT_EQ(s2.version, 2u);
+  EXPECT_FLOAT_EQ(s2.value->at(0), 2.f);
+  EXPECT_FLOAT_EQ(s1.value->at(0), 1.f);
+
+  // only double-buffered outputs are published
+  EXPECT_FALSE(p_node->get_snapshot<float>("out").value);
+
+  auto v = g.add_node<Value>(1.f);
+  g.update();
+  EXPECT_FALSE(g.get_node_ref_by_id(v)->get_snapshot<float>("value").value);
+
+  EXPECT_THROW(p_node->set_output_double_buffered("in"), std::runtime_error);
+}
+
+TEST(NodeDoubleBuffer, ConcurrentReader)
+{
+  gnode::Graph g;
+  auto         id = g.add_node<Counter>();
+  auto        *p_node = g.get_node_ref_by_id(id);
+
+  std::atomic<bool>   is_done = false;
+  std::atomic<size_t> reads = 0;
+  size_t              torn = 0;
+
+  g.update();
+
+  // preview drawn while the graph is updated
+  std::thread reader(
+      [&]()
+      {
+        uint64_t last_version = 0;
+
+        while (!is_done.load())
+        {
+          auto snapshot = p_node->get_snapshot<Buffer>("out");
+          ++reads;
+          EXPECT_GE(snapshot.version, last_version);
+          last_version = snapshot.version;
+
+          for (float v : *snapshot.value)
+            if (v != float(snapshot.version)) ++torn;
+        }
+      });
+
+  for (int k = 0; k < 200; ++k)
+    g.update();
+
+  while (reads.load() == 0)
+    std::this_thread::yield();
+
+  is_done = true;
+  reader.join();
+
+  EXPECT_EQ(torn, 0u);
+  EXPECT_EQ(p_node->get_snapshot<Buffer>("out").version, 201u);
+}
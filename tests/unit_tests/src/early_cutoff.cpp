@@ -0,0 +1,224 @@
+#include <gtest/gtest.h>
+
+#include "nodes.hpp"
+
+class Clamp : public gnode::Node
+{
+public:
+  Clamp() : gnode::Node("Clamp")
+  {
+    add_port<float>(gnode::PortType::IN, "in");
+    add_port<float>(gnode::PortType::OUT, "out");
+  }
+
+  void compute() override
+  {
+    auto *in = get_value_ref<float>("in");
+    if (in) *get_value_ref<float>("out") = std::min(*in, 1.f);
+  }
+};
+
+// without a unique object representation, not hashed
+struct Opaque
+{
+  std::vector<float> values;
+  std::string        name;
+};
+
+class OpaqueNode : public gnode::Node
+{
+public:
+  OpaqueNode() : gnode::Node("OpaqueNode")
+  {
+    add_port<float>(gnode::PortType::IN, "in");
+    add_port<Opaque>(gnode::PortType::OUT, "out");
+  }
+
+  void compute() override {}
+};
+
+using SharedVector = std::shared_ptr<std::vector<float>>;
+
+// output sharing its buffer, the pointee being updated in place
+class SharedBuffer : public gnode::Node
+{
+public:
+  SharedBuffer() : gnode::Node("SharedBuffer")
+  {
+    add_port<float>(gnode::PortType::IN, "in");
+    add_port<SharedVector>(gnode::PortType::OUT, "out");
+    *get_value_ref<SharedVector>("out") = std::make_shared<std::vector<float>>(
+        4,
+        0.f);
+  }
+
+  void compute() override
+  {
+    auto *in = get_value_ref<float>("in");
+    auto &p_buffer = *get_value_ref<SharedVector>("out");
+    if (in) std::fill(p_buffer->begin(), p_buffer->end(), *in);
+  }
+};
+
+TEST(GraphEarlyCutoff, DataHash)
+{
+  gnode::Data<float>              f1(1.f), f2(1.f), f3(2.f);
+  gnode::Data<std::vector<float>> v1(3, 1.f), v2(3, 1.f), v3(4, 1.f);
+  gnode::Data<std::string>        s1("abc"), s2("abc");
+  gnode::Data<Opaque>             o;
+  gnode::Data<float *>            p;
+  gnode::Data<SharedVector>       sp(std::make_shared<std::vector<float>>());
+
+  EXPECT_EQ(f1.get_hash(), f2.get_hash());
+  EXPECT_NE(f1.get_hash(), f3.get_hash());
+  EXPECT_EQ(v1.get_hash(), v2.get_hash());
+  EXPECT_NE(v1.get_hash(), v3.get_hash());
+  EXPECT_EQ(s1.get_hash(), s2.get_hash());
+  EXPECT_FALSE(o.get_hash().has_value());
+  EXPECT_FALSE(p.get_hash().has_value());
+  EXPECT_FALSE(sp.get_hash().has_value());
+}
+
+TEST(GraphEarlyCutoff, UnchangedOutputsStopPropagation)
+{
+  int count_a = 0;
+  int count_b = 0;
+
+  gnode::Graph g;
+  g.set_early_cutoff(true);
+
+  auto v = g.add_node<Value>(2.f);
+  auto c = g.add_node<Clamp>();
+  auto a = g.add_node<CountingAdd>(&count_a);
+  auto b = g.add_node<CountingAdd>(&count_b);
+
+  g.new_link(v, "value", c, "in");
+  g.new_link(c, "out", a, "a");
+  g.new_link(c, "out", a, "b");
+  g.new_link(a, "a + b", b, "a");
+  g.new_link(a, "a + b", b, "b");
+
+  g.update();
+  EXPECT_EQ(count_a, 1);
+  EXPECT_EQ(count_b, 1);
+
+  // the clamp output is unchanged
+  g.get_node_ref_by_id(v)->set_value<float>("value", 5.f);
+  g.update(v);
+
+  EXPECT_EQ(count_a, 1);
+  EXPECT_EQ(count_b, 1);
+
+  for (const auto &[_, p_node] : g.get_nodes())
+    EXPECT_FALSE(p_node->is_dirty);
+
+  // the clamp output changes
+  g.get_node_ref_by_id(v)->set_value<float>("value", 0.5f);
+  g.update(v);
+
+  EXPECT_EQ(count_a, 2);
+  EXPECT_EQ(count_b, 2);
+  EXPECT_FLOAT_EQ(*g.get_node_ref_by_id(b)->get_value_ref<float>("a + b"),
+                  2.f);
+
+  // an explicitly requested node is always computed
+  g.update(a);
+  EXPECT_EQ(count_a, 3);
+
+  // a new link forces the update of the node it ends on
+  auto a2 = g.add_node<CountingAdd>(&count_a);
+  g.new_link(c, "out", a2, "a");
+  g.get_node_ref_by_id(v)->set_value<float>("value", 0.5f);
+  g.update(v);
+  EXPECT_EQ(count_a, 4);
+
+  // without cutoff, everything downstream is computed
+  g.set_early_cutoff(false);
+  g.update(v);
+  EXPECT_EQ(count_a, 6);
+  EXPECT_EQ(count_b, 3);
+}
+
+TEST(GraphEarlyCutoff, UnhashableOutputs)
+{
+  int count = 0;
+
+  gnode::Graph g;
+  g.set_early_cutoff(true);
+
+  auto v = g.add_node<Value>(2.f);
+  auto o = g.add_node<OpaqueNode>();
+  auto a = g.add_node<CountingAdd>(&count);
+
+  // input of the same type as the unhashable output
+  g.get_node_ref_by_id(a)->add_port<Opaque>(gnode::PortType::IN, "opaque");
+
+  g.new_link(v, "value", o, "in");
+  g.new_link(o, "out", a, "opaque");
+
+  g.update();
+
+  for (float value : {3.f, 4.f})
+  {
+    g.get_node_ref_by_id(v)->set_value<float>("value", value);
+    g.update(v);
+  }
+
+  EXPECT_EQ(count, 3);
+}
+
+TEST(GraphEarlyCutoff, SharedPointee)
+{
+  int count = 0;
+
+  gnode::Graph g;
+  g.set_early_cutoff(true);
+
+  auto v = g.add_node<Value>(2.f);
+  auto s = g.add_node<SharedBuffer>();
+  auto a = g.add_node<CountingAdd>(&count);
+
+  g.get_node_ref_by_id(a)->add_port<SharedVector>(gnode::PortType::IN,
+                                                  "buffer");
+
+  g.new_link(v, "value", s, "in");
+  g.new_link(s, "out", a, "buffer");
+
+  g.update();
+
+  // same pointer, new pointee values
+  for (float value : {3.f, 4.f})
+  {
+    g.get_node_ref_by_id(v)->set_value<float>("value", value);
+    g.update(v);
+  }
+
+  EXPECT_EQ(count, 3);
+  EXPECT_FLOAT_EQ(
+      (*g.get_node_ref_by_id(s)->get_value_ref<SharedVector>("out"))->front(),
+      4.f);
+}
+
+TEST(GraphEarlyCutoff, DemandEvaluation)
+{
+  int count = 0;
+
+  gnode::Graph g;
+  g.set_early_cutoff(true);
+
+  auto v = g.add_node<Value>(2.f);
+  auto c = g.add_node<Clamp>();
+  auto a = g.add_node<CountingAdd>(&count);
+
+  g.new_link(v, "value", c, "in");
+  g.new_link(c, "out", a, "a");
+
+  g.update();
+
+  g.get_node_ref_by_id(v)->set_value<float>("value", 3.f);
+  g.mark_dirty(v);
+  g.evaluate({a});
+
+  EXPECT_EQ(count, 1);
+  EXPECT_FALSE(g.get_node_ref_by_id(a)->is_dirty);
+}
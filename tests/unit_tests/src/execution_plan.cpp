@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+
+#include "nodes.hpp"
+
+// counting Add opting in the result caches
+class CachedAdd : public CountingAdd
+{
+public:
+  using CountingAdd::CountingAdd;
+
+  std::optional<uint64_t> get_parameters_hash() const override { return 0; }
+};
+
+// v1 + v2 -> a1, a1 + v2 -> a2
+struct Chain
+{
+  Chain()
+  {
+    v1 = g.add_node<Value>(1.f);
+    v2 = g.add_node<Value>(2.f);
+    a1 = g.add_node<Add>();
+    a2 = g.add_node<Add>();
+
+    g.new_link(v1, "value", a1, "a");
+    g.new_link(v2, "value", a1, "b");
+    g.new_link(a1, "a + b", a2, "a");
+    g.new_link(v2, "value", a2, "b");
+  }
+
+  float get_result() const
+  {
+    return *g.get_node_ref_by_id(a2)->get_value_ref<float>("a + b");
+  }
+
+  gnode::Graph g;
+  std::string  v1, v2, a1, a2;
+};
+
+TEST(GraphExecutionPlan, Compile)
+{
+  Chain chain;
+
+  EXPECT_FALSE(chain.g.is_compiled());
+
+  const gnode::ExecutionPlan &plan = chain.g.compile();
+
+  EXPECT_TRUE(chain.g.is_compiled());
+  ASSERT_EQ(plan.nodes.size(), 4u);
+  EXPECT_EQ(plan.tasks.size(), 4u);
+
+  // topological order
+  auto position = [&](const std::string &id)
+  {
+    auto *p_node = chain.g.get_node_ref_by_id(id);
+    return std::find(plan.nodes.begin(), plan.nodes.end(), p_node) -
+           plan.nodes.begin();
+  };
+
+  EXPECT_LT(position(chain.v1), position(chain.a1));
+  EXPECT_LT(position(chain.v2), position(chain.a1));
+  EXPECT_LT(position(chain.a1), position(chain.a2));
+  EXPECT_EQ(plan.tasks.in_degree[position(chain.a2)], 2u);
+}
+
+TEST(GraphExecutionPlan, Run)
+{
+  Chain chain;
+
+  chain.g.compile();
+  chain.g.run();
+  EXPECT_FLOAT_EQ(chain.get_result(), 5.f);
+
+  chain.g.get_node_ref_by_id(chain.v1)->set_value<float>("value", 10.f);
+  chain.g.run();
+  EXPECT_FLOAT_EQ(chain.get_result(), 14.f);
+
+  // parallel executor
+  chain.g.set_executor(std::make_shared<gnode::ThreadPoolExecutor>(4));
+  chain.g.get_node_ref_by_id(chain.v2)->set_value<float>("value", 1.f);
+  chain.g.run();
+  EXPECT_FLOAT_EQ(chain.get_result(), 12.f);
+}
+
+TEST(GraphExecutionPlan, RunAfterAsyncUpdate)
+{
+  Chain chain;
+
+  chain.g.set_executor(std::make_shared<gnode::ThreadPoolExecutor>(4));
+  auto update = chain.g.update_async(chain.v1);
+
+  // the update in flight is cancelled or completed first
+  chain.g.run();
+
+  EXPECT_EQ(update.wait_for(std::chrono::seconds(0)),
+            std::future_status::ready);
+  EXPECT_FLOAT_EQ(chain.get_result(), 5.f);
+}
+
+TEST(GraphExecutionPlan, Invalidation)
+{
+  Chain          chain;
+  const uint64_t version = chain.g.get_topology_version();
+
+  chain.g.compile();
+
+  // value changes keep the plan
+  chain.g.get_node_ref_by_id(chain.v1)->set_value<float>("value", 3.f);
+  EXPECT_TRUE(chain.g.is_compiled());
+
+  // structural changes invalidate it
+  chain.g.remove_link(chain.v2, "value", chain.a2, "b");
+  EXPECT_FALSE(chain.g.is_compiled());
+  EXPECT_GT(chain.g.get_topology_version(), version);
+
+  auto v3 = chain.g.add_node<Value>(100.f);
+  chain.g.new_link(v3, "value", chain.a2, "b");
+
+  // compiled again by run
+  chain.g.run();
+  EXPECT_TRUE(chain.g.is_compiled());
+  EXPECT_EQ(chain.g.compile().nodes.size(), 5u);
+  EXPECT_FLOAT_EQ(chain.get_result(), 105.f);
+
+  chain.g.remove_node(v3);
+  EXPECT_FALSE(chain.g.is_compiled());
+}
+
+TEST(GraphExecutionPlan, BypassCaches)
+{
+  int count = 0;
+
+  gnode::Graph g;
+  auto         p_cache = std::make_shared<gnode::ResultCache>();
+  g.set_result_cache(p_cache);
+
+  auto v = g.add_node<Value>(1.f);
+  auto a = g.add_node<CachedAdd>(&count);
+  g.new_link(v, "value", a, "a");
+  g.new_link(v, "value", a, "b");
+
+  // computed by each run, the cache being neither read nor filled
+  g.run();
+  g.run();
+
+  EXPECT_EQ(count, 2);
+  EXPECT_EQ(p_cache->get_stats().entries, 0u);
+  EXPECT_EQ(p_cache->get_stats().hits + p_cache->get_stats().misses, 0u);
+
+  // still used by the regular updates
+  g.update();
+  g.update(a);
+
+  EXPECT_EQ(count, 3);
+  EXPECT_EQ(p_cache->get_stats().hits, 1u);
+}
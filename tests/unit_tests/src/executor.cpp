@@ -0,0 +1,165 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "nodes.hpp"
+
+class SlowAdd : public Add
+{
+public:
+  SlowAdd(std::atomic<int> *p_running, std::atomic<int> *p_max_running)
+      : p_running(p_running), p_max_running(p_max_running)
+  {
+  }
+
+  void compute() override
+  {
+    int running = ++(*this->p_running);
+
+    int max_running = this->p_max_running->load();
+    while (running > max_running &&
+           !this->p_max_running->compare_exchange_weak(max_running, running))
+    {
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    Add::compute();
+    --(*this->p_running);
+  }
+
+private:
+  std::atomic<int> *p_running;
+  std::atomic<int> *p_max_running;
+};
+
+class Throw : public Add
+{
+public:
+  void compute() override { throw std::runtime_error("compute failed"); }
+};
+
+// root -> W parallel branches of depth D -> reduction chain
+static std::string build_branches(gnode::Graph     &g,
+                                  int               width,
+                                  int               depth,
+                                  std::atomic<int> *p_running,
+                                  std::atomic<int> *p_max_running)
+{
+  auto root = g.add_node<Value>(1.f);
+  auto sum = g.add_node<Value>(0.f);
+
+  for (int i = 0; i < width; ++i)
+  {
+    std::string prev = root;
+
+    for (int j = 0; j < depth; ++j)
+    {
+      auto id = g.add_node<SlowAdd>(p_running, p_max_running);
+      g.new_link(prev, j == 0 ? "value" : "a + b", id, "a");
+      g.new_link(root, "value", id, "b");
+      prev = id;
+    }
+
+    auto add = g.add_node<Add>();
+    g.new_link(sum, i == 0 ? "value" : "a + b", add, "a");
+    g.new_link(prev, "a + b", add, "b");
+    sum = add;
+  }
+
+  return sum;
+}
+
+TEST(GraphExecutor, ThreadPoolMatchesSerial)
+{
+  std::atomic<int> running = 0;
+  std::atomic<int> max_running = 0;
+
+  gnode::Graph g;
+  auto         sink = build_branches(g, 8, 3, &running, &max_running);
+
+  g.update();
+  float expected = *g.get_node_ref_by_id(sink)->get_value_ref<float>("a + b");
+  EXPECT_FLOAT_EQ(expected, 8.f * 4.f);
+  EXPECT_EQ(max_running.load(), 1);
+
+  auto p_executor = std::make_shared<gnode::ThreadPoolExecutor>(4);
+  g.set_executor(p_executor);
+
+  std::vector<std::string> done;
+  int                      before_count = 0;
+
+  g.set_update_callback(
+      [&](const std::string &nid, const std::vector<std::string> &, bool before)
+      {
+        // callbacks are serialized, no locking should be needed here
+        if (before)
+          before_count++;
+        else
+          done.push_back(nid);
+      });
+
+  g.get_node_ref_by_id(sink)->set_value<float>("a + b", 0.f);
+  g.update();
+
+  EXPECT_FLOAT_EQ(*g.get_node_ref_by_id(sink)->get_value_ref<float>("a + b"),
+                  expected);
+  EXPECT_GT(max_running.load(), 1);
+  EXPECT_EQ(before_count, static_cast<int>(g.get_nodes().size()));
+  EXPECT_EQ(done.size(), g.get_nodes().size());
+
+  // completion order is compatible with the links
+  std::map<std::string, size_t> position;
+  for (size_t k = 0; k < done.size(); ++k)
+    position[done[k]] = k;
+
+  for (const auto &link : g.get_links())
+    EXPECT_LT(position.at(link.from), position.at(link.to));
+}
+
+TEST(GraphExecutor, DeterministicSwitch)
+{
+  std::atomic<int> running = 0;
+  std::atomic<int> max_running = 0;
+
+  gnode::Graph g;
+  build_branches(g, 4, 2, &running, &max_running);
+
+  g.set_executor(std::make_shared<gnode::ThreadPoolExecutor>(4));
+  g.set_deterministic(true);
+
+  std::vector<std::string> order;
+  g.set_update_callback(
+      [&](const std::string &nid, const std::vector<std::string> &, bool before)
+      {
+        if (before) order.push_back(nid);
+      });
+
+  g.update();
+
+  EXPECT_EQ(max_running.load(), 1);
+  EXPECT_EQ(order, g.get_topological_order());
+}
+
+TEST(GraphExecutor, ExceptionIsRethrown)
+{
+  gnode::Graph g;
+
+  auto v = g.add_node<Value>(1.f);
+  auto t = g.add_node<Throw>();
+  auto a = g.add_node<Add>();
+
+  g.new_link(v, "value", t, "a");
+  g.new_link(t, "a + b", a, "a");
+
+  g.set_executor(std::make_shared<gnode::ThreadPoolExecutor>(2));
+
+  EXPECT_THROW(g.update(), std::runtime_error);
+  EXPECT_TRUE(g.get_node_ref_by_id(a)->is_dirty);
+
+  // the executor is still usable
+  g.remove_node(t);
+  EXPECT_NO_THROW(g.update());
+  EXPECT_FALSE(g.get_node_ref_by_id(a)->is_dirty);
+}
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+
+#include "nodes.hpp"
+
+TEST(GraphHandles, StaleHandleAfterRemoval)
+{
+  gnode::Graph g;
+
+  auto v = g.add_node<Value>(1.f);
+  auto a = g.add_node<Add>();
+
+  g.new_link(v, "value", a, "a");
+
+  gnode::NodeHandle h_v = g.get_node_handle(v);
+  gnode::NodeHandle h_a = g.get_node_handle(a);
+
+  ASSERT_TRUE(g.is_handle_valid(h_a));
+  EXPECT_EQ(g.get_node_ref(h_a), g.get_node_ref_by_id(a));
+  EXPECT_EQ(g.get_node_id(h_a), a);
+  EXPECT_EQ(g.get_node_ref<Add>(h_a)->get_handle(), h_a);
+
+  ASSERT_EQ(g.get_edges_downstream(h_v).size(), 1u);
+  EXPECT_EQ(g.get_edges_downstream(h_v)[0].node, h_a);
+  EXPECT_EQ(g.get_edges_upstream(h_a)[0].node, h_v);
+
+  g.remove_node(a);
+
+  EXPECT_FALSE(g.is_handle_valid(h_a));
+  EXPECT_EQ(g.get_node_ref(h_a), nullptr);
+  EXPECT_TRUE(g.get_edges_downstream(h_v).empty());
+
+  // the released slot is reused with a new generation
+  auto              b = g.add_node<Add>();
+  gnode::NodeHandle h_b = g.get_node_handle(b);
+
+  EXPECT_EQ(h_b.index, h_a.index);
+  EXPECT_NE(h_b.generation, h_a.generation);
+  EXPECT_FALSE(g.is_handle_valid(h_a));
+  EXPECT_TRUE(g.is_handle_valid(h_b));
+
+  g.new_link(v, "value", b, "b");
+  EXPECT_EQ(g.get_links().size(), 1u);
+  EXPECT_EQ(g.get_links_upstream(b)[0].from, v);
+}
+
+TEST(GraphHandles, StaleHandleAfterClear)
+{
+  gnode::Graph g;
+
+  auto              v = g.add_node<Value>(1.f);
+  gnode::NodeHandle h_v = g.get_node_handle(v);
+
+  g.clear();
+  EXPECT_FALSE(g.is_handle_valid(h_v));
+
+  // the slot is reused, but not the handle
+  auto              w = g.add_node<Value>(2.f);
+  gnode::NodeHandle h_w = g.get_node_handle(w);
+
+  EXPECT_EQ(h_w.index, h_v.index);
+  EXPECT_FALSE(g.is_handle_valid(h_v));
+  EXPECT_EQ(g.get_node_ref(h_v), nullptr);
+  EXPECT_TRUE(g.is_handle_valid(h_w));
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include "nodes.hpp"
+
+class Gain : public gnode::Node
+{
+public:
+  Gain() : gnode::Node("Gain")
+  {
+    add_port<Buffer>(gnode::PortType::IN, "in");
+    add_port<Buffer>(gnode::PortType::OUT, "out");
+    set_input_in_place("in");
+  }
+
+  void compute() override
+  {
+    Buffer *out = take_input<Buffer>("in", "out");
+    if (!out) return;
+
+    for (auto &v : *out)
+      v *= 2.f;
+  }
+};
+
+TEST(NodeInPlace, SoleConsumer)
+{
+  int count = 0;
+
+  gnode::Graph g;
+  auto         s = g.add_node<BufferSource>(&count);
+  auto         g1 = g.add_node<Gain>();
+  auto         g2 = g.add_node<Gain>();
+  g.new_link(s, "out", g1, "in");
+  g.new_link(g1, "out", g2, "in");
+  g.update();
+
+  // the buffer is handed over along the chain
+  EXPECT_EQ(get_buffer(g, g2).data(),
+            g.get_node_ref_by_id<BufferSource>(s)->p_buffer);
+  EXPECT_FLOAT_EQ(first_value(g, g2), 4.f);
+  EXPECT_EQ(g.get_memory_usage(), buffer_bytes);
+  EXPECT_EQ(residency(g, s), gnode::DataResidency::DROPPED);
+  EXPECT_EQ(residency(g, g1), gnode::DataResidency::DROPPED);
+
+  // released outputs are recomputed on access
+  EXPECT_FLOAT_EQ(first_value(g, g1), 2.f);
+  EXPECT_EQ(count, 2);
+}
+
+TEST(NodeInPlace, CopyOnWrite)
+{
+  int count = 0;
+
+  gnode::Graph g;
+  auto         s = g.add_node<BufferSource>(&count);
+  auto         g1 = g.add_node<Gain>();
+  auto         g2 = g.add_node<Gain>();
+  g.new_link(s, "out", g1, "in");
+  g.new_link(s, "out", g2, "in");
+  g.update();
+
+  // two consumers, the source output is copied
+  EXPECT_EQ(residency(g, s), gnode::DataResidency::RESIDENT);
+  EXPECT_FLOAT_EQ(first_value(g, s), 1.f);
+  EXPECT_FLOAT_EQ(first_value(g, g1), 2.f);
+  EXPECT_FLOAT_EQ(first_value(g, g2), 2.f);
+
+  // pinned output
+  g.remove_link(s, "out", g2, "in");
+  g.get_node_ref_by_id(s)->set_output_pinned("out");
+  g.update();
+
+  EXPECT_EQ(residency(g, s), gnode::DataResidency::RESIDENT);
+  EXPECT_FLOAT_EQ(first_value(g, g1), 2.f);
+
+  // not flagged
+  g.get_node_ref_by_id(s)->set_output_pinned("out", false);
+  g.get_node_ref_by_id(g1)->set_input_in_place("in", false);
+  g.update();
+
+  EXPECT_EQ(residency(g, s), gnode::DataResidency::RESIDENT);
+  EXPECT_EQ(count, 3);
+
+  EXPECT_THROW(g.get_node_ref_by_id(g1)->set_input_in_place("out"),
+               std::invalid_argument);
+}
+
+TEST(NodeInPlace, BoundLink)
+{
+  gnode::Graph g;
+  auto         s1 = g.add_node<BufferSource>();
+  auto         s2 = g.add_node<BufferSource>();
+  auto         g1 = g.add_node<Gain>();
+  auto         g2 = g.add_node<Gain>();
+
+  // the input of g1 reads the output of s2, the last link bound, which also
+  // feeds g2
+  g.new_link(s1, "out", g1, "in");
+  g.new_link(s2, "out", g1, "in");
+  g.new_link(s2, "out", g2, "in");
+  g.update();
+
+  EXPECT_EQ(residency(g, s1), gnode::DataResidency::RESIDENT);
+  EXPECT_EQ(residency(g, s2), gnode::DataResidency::RESIDENT);
+  EXPECT_FLOAT_EQ(first_value(g, s2), 1.f);
+  EXPECT_FLOAT_EQ(first_value(g, g1), 2.f);
+  EXPECT_FLOAT_EQ(first_value(g, g2), 2.f);
+}
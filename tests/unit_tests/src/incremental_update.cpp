@@ -66,3 +66,56 @@ TEST(GraphStress, IncrementalUpdate5000Nodes)
                 ->get_value_ref<float>("a + b");
   EXPECT_FLOAT_EQ(result, 10002.f);
 }
+
+TEST(GraphUpdate, TopologyChangeBetweenUpdates)
+{
+  gnode::Graph g;
+
+  // downstream node created first, so that the ID order is not a valid
+  // topological order
+  auto add = g.add_node<Add>();
+  auto v1 = g.add_node<Value>(2.f);
+  auto v2 = g.add_node<Value>(3.f);
+
+  g.new_link(v1, "value", add, "a");
+  g.new_link(v1, "value", add, "b");
+
+  g.update();
+
+  auto *out = g.get_node_ref_by_id<Add>(add)->get_value_ref<float>("a + b");
+  EXPECT_FLOAT_EQ(*out, 4.f);
+
+  // cached order must follow the structural edits
+  const auto order = g.get_topological_order();
+  ASSERT_EQ(order.size(), 3u);
+  EXPECT_LT(std::find(order.begin(), order.end(), v1),
+            std::find(order.begin(), order.end(), add));
+
+  g.remove_link(v1, "value", add, "b");
+  g.new_link(v2, "value", add, "b");
+
+  g.update();
+  EXPECT_FLOAT_EQ(*out, 5.f);
+
+  auto v3 = g.add_node<Value>(1.f);
+  EXPECT_EQ(g.get_topological_order().back(), v3);
+
+  // the remaining nodes keep their order
+  std::vector<std::string> expected = g.get_topological_order();
+  expected.erase(std::find(expected.begin(), expected.end(), v1));
+
+  g.remove_node(v1);
+  EXPECT_EQ(g.get_topological_order(), expected);
+
+  // slot of a removed node reused before the order is read again
+  const uint32_t index = g.get_node_handle(v3).index;
+
+  g.remove_node(v3);
+  expected.pop_back();
+
+  auto v4 = g.add_node<Value>(2.f);
+  expected.push_back(v4);
+
+  EXPECT_EQ(g.get_node_handle(v4).index, index);
+  EXPECT_EQ(g.get_topological_order(), expected);
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include "nodes.hpp"
+
+TEST(GraphLinkIndex, DuplicateAndRemoval)
+{
+  gnode::Graph g;
+
+  auto v = g.add_node<Value>(1.f);
+  auto a1 = g.add_node<Add>();
+  auto a2 = g.add_node<Add>();
+
+  EXPECT_TRUE(g.new_link(v, "value", a1, "a"));
+  EXPECT_FALSE(g.new_link(v, "value", a1, "a"));
+  EXPECT_TRUE(g.new_link(v, "value", a1, "b"));
+  EXPECT_TRUE(g.new_link(a1, "a + b", a2, "a"));
+  EXPECT_TRUE(g.new_link(v, "value", a2, "b"));
+
+  EXPECT_TRUE(g.remove_link(v, "value", a1, "b"));
+  EXPECT_FALSE(g.remove_link(v, "value", a1, "b"));
+
+  // removal keeps the creation order of the other links, the storage being
+  // returned without any copy
+  const std::vector<gnode::Link> &links = g.get_links();
+
+  std::vector<gnode::Link> expected = {{v, 0, a1, 0},
+                                       {a1, 2, a2, 0},
+                                       {v, 0, a2, 1}};
+  EXPECT_EQ(links, expected);
+  EXPECT_EQ(&links, &g.get_links());
+
+  // a removed link can be created again
+  EXPECT_TRUE(g.new_link(v, "value", a1, "b"));
+  EXPECT_EQ(g.get_links().back(), gnode::Link(v, 0, a1, 1));
+
+  const gnode::Link *p_link = g.get_input_link(a2, 0);
+  ASSERT_NE(p_link, nullptr);
+  EXPECT_EQ(*p_link, gnode::Link(a1, 2, a2, 0));
+
+  g.remove_node(a1);
+
+  EXPECT_EQ(g.get_input_link(a2, 0), nullptr);
+  EXPECT_EQ(g.get_links(), std::vector<gnode::Link>({{v, 0, a2, 1}}));
+  EXPECT_EQ(g.get_edges_downstream(g.get_node_handle(v)).size(), 1u);
+}
+
+TEST(GraphLinkIndex, InputFedByTwoLinks)
+{
+  gnode::Graph g;
+
+  auto v1 = g.add_node<Value>(1.f);
+  auto v2 = g.add_node<Value>(2.f);
+  auto add = g.add_node<Add>();
+
+  g.new_link(v1, "value", add, "a");
+  g.new_link(v2, "value", add, "a");
+  g.new_link(v1, "value", add, "b");
+
+  EXPECT_EQ(g.get_input_link(add, 0)->from, v2);
+
+  // the remaining link takes over the input
+  g.remove_link(v2, "value", add, "a");
+  EXPECT_EQ(g.get_input_link(add, 0)->from, v1);
+
+  g.update();
+  EXPECT_FLOAT_EQ(*g.get_node_ref_by_id(add)->get_value_ref<float>("a + b"),
+                  2.f);
+
+  g.remove_link(v1, "value", add, "a");
+  EXPECT_EQ(g.get_input_link(add, 0), nullptr);
+  EXPECT_EQ(g.get_node_ref_by_id(add)->get_value_ref<float>("a"), nullptr);
+}
+
+TEST(GraphStress, BulkLinkEdition)
+{
+  gnode::Graph g;
+
+  constexpr int N = 100000;
+
+  auto root = g.add_node<Value>(1.f);
+
+  std::vector<std::string> adds;
+
+  for (int i = 0; i < N; ++i)
+  {
+    adds.push_back(g.add_node<Add>());
+    g.new_link(root, "value", adds.back(), "a");
+    g.new_link(root, "value", adds.back(), "b");
+    EXPECT_FALSE(g.new_link(root, "value", adds.back(), "b"));
+  }
+
+  EXPECT_EQ(g.get_links().size(), static_cast<size_t>(2 * N));
+
+  // remove every other link, interleaved with queries
+  for (int i = 0; i < N; i += 2)
+  {
+    EXPECT_TRUE(g.remove_link(root, "value", adds[i], "b"));
+    EXPECT_EQ(g.get_input_link(adds[i], 1), nullptr);
+    EXPECT_NE(g.get_input_link(adds[i], 0), nullptr);
+  }
+
+  // the remaining links are listed in their insertion order, the removed rows
+  // of the link table having been compacted on the way
+  auto check_order = [&]()
+  {
+    const auto &links = g.get_links();
+    ASSERT_EQ(links.size(), static_cast<size_t>(2 * N - N / 2));
+
+    size_t k = 0;
+
+    for (int i = 0; i < N; ++i)
+    {
+      EXPECT_EQ(links[k++], gnode::Link(root, 0, adds[i], 0));
+      if (i % 2) EXPECT_EQ(links[k++], gnode::Link(root, 0, adds[i], 1));
+    }
+
+    for (const auto &link : links)
+      EXPECT_EQ(*g.get_input_link(link.to, link.port_to), link);
+  };
+
+  check_order();
+
+  // a further compaction, triggered by the removal of most of the links
+  for (int i = N / 2; i < N; ++i)
+    g.remove_node(adds[i]);
+
+  std::vector<gnode::Link> expected;
+
+  for (int i = 0; i < N / 2; ++i)
+  {
+    expected.emplace_back(root, 0, adds[i], 0);
+    if (i % 2) expected.emplace_back(root, 0, adds[i], 1);
+  }
+
+  EXPECT_EQ(g.get_links(), expected);
+
+  // removing the hub only visits its own links
+  g.remove_node(root);
+  EXPECT_TRUE(g.get_links().empty());
+  EXPECT_EQ(g.get_input_link(adds.front(), 1), nullptr);
+}
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include "nodes.hpp"
+
+class Increment : public gnode::Node
+{
+public:
+  explicit Increment(int *p_count) : gnode::Node("Increment"), p_count(p_count)
+  {
+    add_port<Buffer>(gnode::PortType::IN, "in");
+    add_port<Buffer>(gnode::PortType::OUT, "out");
+  }
+
+  void compute() override
+  {
+    auto *in = get_value_ref<Buffer>("in");
+    auto *out = get_value_ref<Buffer>("out");
+
+    *out = *in;
+    for (auto &v : *out)
+      v += 1.f;
+
+    ++(*this->p_count);
+  }
+
+private:
+  int *p_count;
+};
+
+// source -> n increments
+static std::vector<std::string> build_chain(gnode::Graph &g,
+                                            int           n,
+                                            int          *p_count)
+{
+  std::vector<std::string> chain = {g.add_node<BufferSource>()};
+
+  for (int i = 0; i < n; ++i)
+  {
+    chain.push_back(g.add_node<Increment>(p_count));
+    g.new_link(chain[i], "out", chain.back(), "in");
+  }
+
+  return chain;
+}
+
+TEST(GraphMemoryBudget, DropAndRecompute)
+{
+  int count = 0;
+
+  gnode::Graph g;
+  auto         chain = build_chain(g, 6, &count);
+
+  g.set_memory_budget(3 * buffer_bytes);
+  g.update();
+
+  EXPECT_EQ(count, 6);
+  EXPECT_LE(g.get_memory_usage(), 3 * buffer_bytes);
+  EXPECT_FLOAT_EQ(first_value(g, chain.back()), 7.f);
+
+  // the least recently used intermediates are evicted
+  EXPECT_EQ(residency(g, chain[1]), gnode::DataResidency::DROPPED);
+  EXPECT_EQ(residency(g, chain[5]), gnode::DataResidency::RESIDENT);
+
+  // transparent recomputation on access
+  count = 0;
+  EXPECT_FLOAT_EQ(first_value(g, chain[2]), 3.f);
+  EXPECT_EQ(count, 2);
+  EXPECT_EQ(residency(g, chain[2]), gnode::DataResidency::RESIDENT);
+
+  for (const auto &[_, p_node] : g.get_nodes())
+    EXPECT_FALSE(p_node->is_dirty);
+
+  // and on a downstream update
+  g.set_memory_budget(0);
+  g.update(chain[4]);
+  EXPECT_FLOAT_EQ(first_value(g, chain.back()), 7.f);
+}
+
+TEST(GraphMemoryBudget, Spill)
+{
+  int count = 0;
+
+  gnode::Graph g;
+  auto         chain = build_chain(g, 6, &count);
+
+  g.set_memory_budget(3 * buffer_bytes, gnode::EvictionMode::SPILL);
+  g.update();
+
+  EXPECT_EQ(residency(g, chain[1]), gnode::DataResidency::SPILLED);
+
+  // read back, not recomputed
+  count = 0;
+  EXPECT_FLOAT_EQ(first_value(g, chain[1]), 2.f);
+  EXPECT_EQ(count, 0);
+  EXPECT_EQ(residency(g, chain[1]), gnode::DataResidency::RESIDENT);
+}
+
+TEST(GraphMemoryBudget, Pinned)
+{
+  int count = 0;
+
+  gnode::Graph g;
+  auto         chain = build_chain(g, 6, &count);
+
+  g.get_node_ref_by_id(chain[1])->set_output_pinned("out");
+  g.set_memory_budget(buffer_bytes);
+  g.update();
+
+  EXPECT_EQ(residency(g, chain[1]), gnode::DataResidency::RESIDENT);
+  EXPECT_EQ(residency(g, chain[2]), gnode::DataResidency::DROPPED);
+
+  EXPECT_THROW(g.get_node_ref_by_id(chain[1])->set_output_pinned("in"),
+               std::invalid_argument);
+}
+
+TEST(GraphMemoryBudget, ParallelUpdate)
+{
+  int count = 0;
+
+  gnode::Graph g;
+  auto         chain = build_chain(g, 6, &count);
+
+  g.set_executor(std::make_shared<gnode::ThreadPoolExecutor>(4));
+  g.set_memory_budget(2 * buffer_bytes);
+  g.update();
+
+  EXPECT_LE(g.get_memory_usage(), 2 * buffer_bytes);
+  EXPECT_FLOAT_EQ(first_value(g, chain.back()), 7.f);
+
+  // the source is recomputed along
+  g.get_node_ref_by_id(chain[3])->is_dirty = true;
+  g.update(chain[3]);
+  EXPECT_FLOAT_EQ(first_value(g, chain.back()), 7.f);
+}
@@ -1,6 +1,9 @@
 // test_nodes.hpp
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "gnode.hpp"
 
 class Add : public gnode::Node
@@ -23,6 +26,44 @@ public:
   }
 };
 
+// Add reading and writing its ports through typed handles
+class TypedAdd : public gnode::Node
+{
+public:
+  TypedAdd() : gnode::Node("TypedAdd")
+  {
+    a = add_port<float>(gnode::PortType::IN, "a");
+    b = add_port<float>(gnode::PortType::IN, "b");
+    out = add_port<float>(gnode::PortType::OUT, "a + b");
+  }
+
+  void compute() override
+  {
+    if (a && b) *out = *a + *b;
+  }
+
+private:
+  gnode::InPort<float>  a;
+  gnode::InPort<float>  b;
+  gnode::OutPort<float> out;
+};
+
+// Add counting its computations
+class CountingAdd : public Add
+{
+public:
+  explicit CountingAdd(int *p_count) : p_count(p_count) {}
+
+  void compute() override
+  {
+    Add::compute();
+    ++(*this->p_count);
+  }
+
+private:
+  int *p_count;
+};
+
 class Value : public gnode::Node
 {
 public:
@@ -35,3 +76,48 @@ public:
 
   void compute() override {}
 };
+
+// float buffers of the memory tests
+using Buffer = std::vector<float>;
+
+inline constexpr size_t buffer_size = 10000;
+inline constexpr size_t buffer_bytes = sizeof(Buffer) +
+                                       buffer_size * sizeof(float);
+
+// fills its output buffer with ones, counting its computations
+class BufferSource : public gnode::Node
+{
+public:
+  explicit BufferSource(int *p_count = nullptr)
+      : gnode::Node("BufferSource"), p_count(p_count)
+  {
+    add_port<Buffer>(gnode::PortType::OUT, "out");
+  }
+
+  void compute() override
+  {
+    get_value_ref<Buffer>("out")->assign(buffer_size, 1.f);
+    this->p_buffer = get_value_ref<Buffer>("out")->data();
+    if (this->p_count) ++(*this->p_count);
+  }
+
+  const float *p_buffer = nullptr;
+
+private:
+  int *p_count;
+};
+
+inline const Buffer &get_buffer(gnode::Graph &g, const std::string &node_id)
+{
+  return *g.get_node_ref_by_id(node_id)->get_value_ref<Buffer>("out");
+}
+
+inline float first_value(gnode::Graph &g, const std::string &node_id)
+{
+  return get_buffer(g, node_id).at(0);
+}
+
+inline gnode::DataResidency residency(gnode::Graph &g, const std::string &id)
+{
+  return g.get_node_ref_by_id(id)->get_base_data("out")->get_residency();
+}
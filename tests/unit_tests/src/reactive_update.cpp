@@ -0,0 +1,119 @@
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "nodes.hpp"
+
+struct ReactiveGraph
+{
+  gnode::Graph             g;
+  std::string              v;
+  std::vector<std::string> adds;
+  int                      update_count = 0;
+
+  ReactiveGraph()
+  {
+    v = g.add_node<Value>(1.f);
+
+    std::string prev = v;
+
+    for (int i = 0; i < 5; ++i)
+    {
+      adds.push_back(g.add_node<Add>());
+      g.new_link(prev, i == 0 ? "value" : "a + b", adds.back(), "a");
+      g.new_link(v, "value", adds.back(), "b");
+      prev = adds.back();
+    }
+
+    g.update();
+
+    g.set_update_callback(
+        [this](const std::string &nid, const std::vector<std::string> &, bool)
+        {
+          if (nid == this->adds.back()) this->update_count++;
+        });
+  }
+
+  float result()
+  {
+    return *g.get_node_ref_by_id(adds.back())->get_value_ref<float>("a + b");
+  }
+};
+
+TEST(GraphReactive, DisabledByDefault)
+{
+  ReactiveGraph r;
+
+  r.g.get_node_ref_by_id(r.v)->set_value<float>("value", 2.f);
+
+  EXPECT_FALSE(r.g.get_node_ref_by_id(r.v)->is_dirty);
+  EXPECT_FALSE(r.g.poll_updates());
+  EXPECT_FLOAT_EQ(r.result(), 6.f);
+}
+
+TEST(GraphReactive, BurstIsCoalesced)
+{
+  ReactiveGraph r;
+
+  r.g.set_reactive(true);
+  r.g.set_update_debounce(0.02);
+  r.g.set_update_latency_budget(10.0);
+
+  for (int i = 0; i < 60; ++i)
+  {
+    r.g.get_node_ref_by_id(r.v)->set_value<float>("value", float(i));
+    EXPECT_FALSE(r.g.poll_updates());
+  }
+
+  EXPECT_TRUE(r.g.get_node_ref_by_id(r.v)->is_dirty);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+
+  EXPECT_TRUE(r.g.poll_updates());
+  EXPECT_FALSE(r.g.poll_updates());
+  EXPECT_EQ(r.update_count, 2); // before and after callbacks
+  EXPECT_FLOAT_EQ(r.result(), 59.f * 6.f);
+}
+
+TEST(GraphReactive, LatencyBudget)
+{
+  ReactiveGraph r;
+
+  r.g.set_reactive(true);
+  r.g.set_update_debounce(10.0);
+  r.g.set_update_latency_budget(0.02);
+
+  // continuous edits, the debounce delay is never reached
+  bool is_updated = false;
+
+  for (int i = 0; i < 100 && !is_updated; ++i)
+  {
+    r.g.get_node_ref_by_id(r.v)->set_value<float>("value", 2.f);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    is_updated = r.g.poll_updates();
+  }
+
+  EXPECT_TRUE(is_updated);
+  EXPECT_FLOAT_EQ(r.result(), 12.f);
+}
+
+TEST(GraphReactive, MergedRoots)
+{
+  ReactiveGraph r;
+
+  r.g.set_reactive(true);
+
+  // an upstream and a downstream edit, merged into one update
+  r.g.get_node_ref_by_id(r.adds[2])->set_value<float>("a + b", 0.f);
+  r.g.get_node_ref_by_id(r.v)->set_value<float>("value", 2.f);
+
+  EXPECT_TRUE(r.g.flush_updates());
+  EXPECT_EQ(r.update_count, 2);
+  EXPECT_FLOAT_EQ(r.result(), 12.f);
+
+  // requests of removed nodes are dropped
+  r.g.request_update(r.adds[0]);
+  r.g.remove_node(r.adds[0]);
+  EXPECT_FALSE(r.g.flush_updates());
+}
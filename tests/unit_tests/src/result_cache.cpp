@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+
+#include "nodes.hpp"
+
+class Scale : public gnode::Node
+{
+public:
+  explicit Scale(int *p_count) : gnode::Node("Scale"), p_count(p_count)
+  {
+    add_port<std::vector<float>>(gnode::PortType::IN, "in");
+    add_port<std::vector<float>>(gnode::PortType::OUT, "out");
+  }
+
+  void compute() override
+  {
+    auto *in = get_value_ref<std::vector<float>>("in");
+    auto *out = get_value_ref<std::vector<float>>("out");
+
+    if (in)
+    {
+      *out = *in;
+      for (auto &v : *out)
+        v *= this->factor;
+    }
+
+    ++(*this->p_count);
+  }
+
+  std::optional<uint64_t> get_parameters_hash() const override
+  {
+    return gnode::hash_bytes(&this->factor, sizeof(float));
+  }
+
+  float factor = 1.f;
+
+private:
+  int *p_count;
+};
+
+class Fill : public gnode::Node
+{
+public:
+  Fill() : gnode::Node("Fill")
+  {
+    add_port<std::vector<float>>(gnode::PortType::OUT, "out", 1000, 1.f);
+  }
+
+  void compute() override {}
+};
+
+TEST(GraphResultCache, ParameterToggle)
+{
+  int count = 0;
+
+  gnode::Graph g;
+  auto         p_cache = std::make_shared<gnode::ResultCache>();
+  g.set_result_cache(p_cache);
+
+  auto f = g.add_node<Fill>();
+  auto s = g.add_node<Scale>(&count);
+  g.new_link(f, "out", s, "in");
+
+  auto *p_scale = g.get_node_ref_by_id<Scale>(s);
+  auto  output = [&]()
+  { return p_scale->get_value_ref<std::vector<float>>("out")->at(0); };
+
+  g.update();
+  EXPECT_EQ(count, 1);
+
+  // A -> B -> A, the last update being restored from the cache
+  p_scale->factor = 2.f;
+  g.update(s);
+  EXPECT_EQ(count, 2);
+  EXPECT_FLOAT_EQ(output(), 2.f);
+
+  p_scale->factor = 1.f;
+  g.update(s);
+  EXPECT_EQ(count, 2);
+  EXPECT_FLOAT_EQ(output(), 1.f);
+
+  p_scale->factor = 2.f;
+  g.update(s);
+  EXPECT_EQ(count, 2);
+  EXPECT_FLOAT_EQ(output(), 2.f);
+
+  // different input data
+  g.get_node_ref_by_id(f)->get_value_ref<std::vector<float>>("out")->at(0) =
+      3.f;
+  g.update(f);
+  EXPECT_EQ(count, 3);
+  EXPECT_FLOAT_EQ(output(), 6.f);
+
+  gnode::CacheStats stats = p_cache->get_stats();
+  EXPECT_EQ(stats.hits, 2u);
+  EXPECT_EQ(stats.misses, 3u);
+  EXPECT_EQ(stats.entries, 3u);
+  EXPECT_GE(stats.bytes, 3 * 1000 * sizeof(float));
+
+  // nodes without parameters hash are not cached
+  EXPECT_EQ(stats.hits + stats.misses, 5u);
+}
+
+TEST(GraphResultCache, Budget)
+{
+  const size_t entry_size = sizeof(std::vector<float>) + 1000 * sizeof(float);
+
+  gnode::ResultCache cache(2 * entry_size);
+
+  gnode::CacheKey key{"Scale", 0, {}};
+  auto            p_data = std::make_shared<gnode::Data<std::vector<float>>>(
+      1000,
+      1.f);
+
+  for (uint64_t k = 0; k < 3; ++k)
+  {
+    key.parameters_hash = k;
+    cache.store(key, {p_data});
+  }
+
+  gnode::CacheStats stats = cache.get_stats();
+  EXPECT_EQ(stats.entries, 2u);
+  EXPECT_EQ(stats.evictions, 1u);
+  EXPECT_EQ(stats.bytes, 2 * entry_size);
+
+  // the oldest entry has been evicted
+  auto p_out = std::make_shared<gnode::Data<std::vector<float>>>();
+
+  key.parameters_hash = 0;
+  EXPECT_FALSE(cache.restore(key, {p_out}));
+
+  key.parameters_hash = 2;
+  EXPECT_TRUE(cache.restore(key, {p_out}));
+  EXPECT_EQ(p_out->get_value_ref()->size(), 1000u);
+
+  cache.set_byte_budget(entry_size);
+  EXPECT_EQ(cache.get_stats().entries, 1u);
+
+  // the most recently used entry is kept
+  EXPECT_TRUE(cache.restore(key, {p_out}));
+
+  // entries larger than the budget are not stored
+  cache.set_byte_budget(10);
+  cache.store(key, {p_data});
+  EXPECT_EQ(cache.get_stats().entries, 0u);
+}
@@ -0,0 +1,152 @@
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "nodes.hpp"
+
+class Sleep : public gnode::Node
+{
+public:
+  explicit Sleep(int duration_ms) : gnode::Node("Sleep"), duration(duration_ms)
+  {
+    add_port<float>(gnode::PortType::IN, "in");
+    add_port<float>(gnode::PortType::OUT, "out");
+  }
+
+  void compute() override
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(this->duration));
+  }
+
+private:
+  int duration;
+};
+
+TEST(GraphScheduling, CostEstimates)
+{
+  gnode::Graph g;
+
+  g.set_cost_seed("Sleep", 0.5);
+
+  auto v = g.add_node<Value>(1.f);
+  auto s = g.add_node<Sleep>(20);
+  g.new_link(v, "value", s, "in");
+
+  EXPECT_DOUBLE_EQ(g.get_cost_estimate(s), 0.5);
+  EXPECT_GT(g.get_cost_estimate(v), 0.0);
+
+  // the seed is replaced by the first measure
+  g.update();
+  double cost = g.get_cost_estimate(s);
+  EXPECT_GE(cost, 0.02);
+  EXPECT_LT(cost, 0.5);
+
+  // the estimate follows the measures
+  g.update(s);
+  g.update(s);
+  EXPECT_GE(g.get_cost_estimate(s), 0.02);
+  EXPECT_LT(g.get_cost_estimate(s), 0.5);
+
+  EXPECT_THROW(g.get_cost_estimate("unknown"), std::runtime_error);
+}
+
+TEST(GraphScheduling, CriticalPathFirst)
+{
+  gnode::Graph g;
+
+  auto v = g.add_node<Value>(1.f);
+
+  // short independent nodes, added first and therefore first in the
+  // topological order
+  for (int i = 0; i < 6; ++i)
+  {
+    auto id = g.add_node<Add>();
+    g.new_link(v, "value", id, "a");
+  }
+
+  // long chain
+  std::string head;
+  std::string prev = v;
+
+  for (int i = 0; i < 4; ++i)
+  {
+    auto id = g.add_node<Sleep>(1);
+    g.new_link(prev, i == 0 ? "value" : "out", id, "in");
+    if (i == 0) head = id;
+    prev = id;
+  }
+
+  g.set_cost_seed("Add", 1.0);
+  g.set_cost_seed("Sleep", 1.0);
+
+  std::vector<std::string> order;
+  g.set_update_callback(
+      [&](const std::string &nid, const std::vector<std::string> &, bool before)
+      {
+        if (before) order.push_back(nid);
+      });
+
+  // a single worker starts the ready nodes by decreasing priority
+  g.set_executor(std::make_shared<gnode::ThreadPoolExecutor>(1));
+  g.update();
+
+  ASSERT_EQ(order.size(), g.get_nodes().size());
+  EXPECT_EQ(order[0], v);
+  EXPECT_EQ(order[1], head);
+
+  // serial execution keeps the topological order
+  order.clear();
+  g.set_executor(nullptr);
+  g.update();
+  EXPECT_EQ(order, g.get_topological_order());
+}
+
+TEST(GraphScheduling, Progress)
+{
+  gnode::Graph g;
+
+  auto v = g.add_node<Value>(1.f);
+
+  std::string prev = v;
+
+  for (int i = 0; i < 10; ++i)
+  {
+    auto id = g.add_node<Sleep>(10);
+    g.new_link(prev, i == 0 ? "value" : "out", id, "in");
+    prev = id;
+  }
+
+  g.set_cost_seed("Sleep", 0.01);
+  g.set_cost_seed("Value", 0.0);
+
+  auto done = g.update_async(v);
+
+  bool  is_partial = false;
+  float last_fraction = 0.f;
+
+  while (done.wait_for(std::chrono::milliseconds(2)) !=
+         std::future_status::ready)
+  {
+    gnode::UpdateProgress progress = g.get_update_progress();
+
+    EXPECT_GE(progress.fraction, last_fraction);
+    last_fraction = progress.fraction;
+
+    if (progress.fraction > 0.f && progress.fraction < 1.f)
+    {
+      is_partial = true;
+      EXPECT_GT(progress.time_remaining, 0.0);
+      EXPECT_LE(progress.time_remaining, 0.1);
+    }
+  }
+
+  EXPECT_TRUE(done.get());
+  EXPECT_TRUE(is_partial);
+
+  gnode::UpdateProgress progress = g.get_update_progress();
+  EXPECT_EQ(progress.nodes_done, 11u);
+  EXPECT_EQ(progress.nodes_total, 11u);
+  EXPECT_FLOAT_EQ(progress.fraction, 1.f);
+  EXPECT_DOUBLE_EQ(progress.time_remaining, 0.0);
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include "nodes.hpp"
+
+class StaticAdd : public gnode::StaticNode<StaticAdd,
+                                           gnode::Inputs<float, float>,
+                                           gnode::Outputs<float>>
+{
+public:
+  StaticAdd() : StaticNode("StaticAdd", {"a", "b"}, {"a + b"}) {}
+
+  void compute(const float &a, const float &b, float &out)
+  {
+    out = a + b;
+    ++this->count;
+  }
+
+  int count = 0;
+};
+
+// several outputs of different types
+class Stats : public gnode::StaticNode<Stats,
+                                       gnode::Inputs<std::vector<float>>,
+                                       gnode::Outputs<float, size_t>>
+{
+public:
+  Stats() : StaticNode("Stats", {"values"}, {"sum", "size"}) {}
+
+  void compute(const std::vector<float> &values, float &sum, size_t &size)
+  {
+    sum = 0.f;
+    for (float v : values)
+      sum += v;
+    size = values.size();
+  }
+};
+
+class Samples : public gnode::StaticNode<Samples,
+                                         gnode::Inputs<>,
+                                         gnode::Outputs<std::vector<float>>>
+{
+public:
+  Samples() : StaticNode("Samples", {}, {"values"}) {}
+
+  void compute(std::vector<float> &values) { values = {1.f, 2.f, 4.f}; }
+};
+
+TEST(StaticNode, Ports)
+{
+  StaticAdd node;
+
+  ASSERT_EQ(node.get_nports(), 3);
+  EXPECT_EQ(node.get_port_type("a"), gnode::PortType::IN);
+  EXPECT_EQ(node.get_port_type("b"), gnode::PortType::IN);
+  EXPECT_EQ(node.get_port_type("a + b"), gnode::PortType::OUT);
+  EXPECT_TRUE(node.has_port<float>("a + b"));
+}
+
+TEST(StaticNode, MixedGraph)
+{
+  gnode::Graph g;
+
+  auto v1 = g.add_node<Value>(1.f);
+  auto v2 = g.add_node<Value>(2.f);
+  auto s = g.add_node<StaticAdd>();
+  auto a = g.add_node<Add>();
+
+  g.new_link(v1, "value", s, "a");
+  g.update();
+
+  // not computed while an input is not connected
+  auto *p_static = g.get_node_ref_by_id<StaticAdd>(s);
+  EXPECT_EQ(p_static->count, 0);
+
+  g.new_link(v2, "value", s, "b");
+  g.new_link(s, "a + b", a, "a");
+  g.new_link(v2, "value", a, "b");
+  g.update();
+
+  EXPECT_EQ(p_static->count, 1);
+  EXPECT_FLOAT_EQ(*p_static->get_value_ref<float>("a + b"), 3.f);
+  EXPECT_FLOAT_EQ(*g.get_node_ref_by_id(a)->get_value_ref<float>("a + b"),
+                  5.f);
+}
+
+TEST(StaticNode, SeveralOutputs)
+{
+  gnode::Graph g;
+
+  auto samples = g.add_node<Samples>();
+  auto stats = g.add_node<Stats>();
+
+  g.new_link(samples, "values", stats, "values");
+  g.update();
+
+  auto *p_stats = g.get_node_ref_by_id(stats);
+  EXPECT_FLOAT_EQ(*p_stats->get_value_ref<float>("sum"), 7.f);
+  EXPECT_EQ(*p_stats->get_value_ref<size_t>("size"), 3u);
+}
@@ -0,0 +1,171 @@
+#include <atomic>
+
+#include <gtest/gtest.h>
+
+#include "nodes.hpp"
+
+using Raster = std::vector<float>;
+
+constexpr int raster_width = 50;
+constexpr int raster_height = 30;
+
+// raster node computed tile by tile, or at once outside of tiled updates
+class RasterNode : public gnode::Node
+{
+public:
+  explicit RasterNode(const std::string &label, int halo)
+      : gnode::Node(label), halo(halo)
+  {
+    add_port<Raster>(gnode::PortType::OUT, "out");
+  }
+
+  void compute() override
+  {
+    this->prepare_tiles();
+    this->compute_region({0, 0, raster_width, raster_height});
+  }
+
+  void compute_tile(const gnode::TileRegion &region) override
+  {
+    ++this->tile_count;
+    this->compute_region(region);
+  }
+
+  std::optional<gnode::TilingScheme> get_tiling() const override
+  {
+    return gnode::TilingScheme{raster_width, raster_height, this->halo};
+  }
+
+  void prepare_tiles() override
+  {
+    get_value_ref<Raster>("out")->resize(raster_width * raster_height);
+  }
+
+  virtual void compute_region(const gnode::TileRegion &region) = 0;
+
+  std::atomic<int> tile_count = 0;
+
+private:
+  int halo;
+};
+
+class Gradient : public RasterNode
+{
+public:
+  Gradient() : RasterNode("Gradient", 0) {}
+
+  void compute_region(const gnode::TileRegion &region) override
+  {
+    auto *p_out = get_value_ref<Raster>("out");
+
+    for (int j = region.y0; j < region.y1; ++j)
+      for (int i = region.x0; i < region.x1; ++i)
+        (*p_out)[j * raster_width + i] = float(i * i + 3 * j);
+  }
+};
+
+// 3x3 box blur, reading one cell around
+class BoxBlur : public RasterNode
+{
+public:
+  BoxBlur() : RasterNode("BoxBlur", 1)
+  {
+    add_port<Raster>(gnode::PortType::IN, "in");
+  }
+
+  void compute_region(const gnode::TileRegion &region) override
+  {
+    auto *p_in = get_value_ref<Raster>("in");
+    auto *p_out = get_value_ref<Raster>("out");
+
+    for (int j = region.y0; j < region.y1; ++j)
+      for (int i = region.x0; i < region.x1; ++i)
+      {
+        float sum = 0.f;
+
+        for (int q = -1; q <= 1; ++q)
+          for (int p = -1; p <= 1; ++p)
+          {
+            const int ip = std::clamp(i + p, 0, raster_width - 1);
+            const int jq = std::clamp(j + q, 0, raster_height - 1);
+            sum += (*p_in)[jq * raster_width + ip];
+          }
+
+        (*p_out)[j * raster_width + i] = sum / 9.f;
+      }
+  }
+};
+
+static std::vector<std::string> build_blur_chain(gnode::Graph &g)
+{
+  std::vector<std::string> ids = {g.add_node<Gradient>()};
+
+  for (int k = 0; k < 3; ++k)
+  {
+    ids.push_back(g.add_node<BoxBlur>());
+    g.new_link(ids[k], "out", ids[k + 1], "in");
+  }
+
+  return ids;
+}
+
+static Raster run_blur_chain(int tile_size, bool is_parallel)
+{
+  gnode::Graph g;
+  auto         ids = build_blur_chain(g);
+
+  g.set_tile_size(tile_size);
+  if (is_parallel)
+    g.set_executor(std::make_shared<gnode::ThreadPoolExecutor>(4));
+
+  g.update();
+  return *g.get_node_ref_by_id(ids.back())->get_value_ref<Raster>("out");
+}
+
+TEST(GraphTiling, TileRegion)
+{
+  gnode::TileRegion region{10, 0, 20, 8};
+
+  EXPECT_EQ(region.get_area(), 80);
+  EXPECT_EQ(region.expanded(2, 21, 100), gnode::TileRegion({8, 0, 21, 10}));
+}
+
+TEST(GraphTiling, MatchesUntiled)
+{
+  const Raster reference = run_blur_chain(0, false);
+
+  // without halo overlap (four phases), and with tiles smaller than the halos
+  // (one tile at a time)
+  for (int tile_size : {8, 16, 4})
+    for (bool is_parallel : {false, true})
+    {
+      const Raster out = run_blur_chain(tile_size, is_parallel);
+
+      ASSERT_EQ(out.size(), reference.size());
+      for (size_t k = 0; k < out.size(); ++k)
+        ASSERT_FLOAT_EQ(out[k], reference[k]) << tile_size << " " << k;
+    }
+}
+
+TEST(GraphTiling, TilesUsed)
+{
+  gnode::Graph g;
+  auto         ids = build_blur_chain(g);
+
+  g.set_tile_size(16);
+  g.update();
+
+  // 4 x 2 tiles
+  for (const auto &id : ids)
+  {
+    auto *p_node = g.get_node_ref_by_id<RasterNode>(id);
+
+    EXPECT_EQ(p_node->tile_count.load(), 8);
+    EXPECT_FALSE(p_node->is_dirty);
+  }
+
+  // dirty nodes only
+  g.update(ids[2]);
+  EXPECT_EQ(g.get_node_ref_by_id<RasterNode>(ids[0])->tile_count.load(), 8);
+  EXPECT_EQ(g.get_node_ref_by_id<RasterNode>(ids[3])->tile_count.load(), 16);
+}
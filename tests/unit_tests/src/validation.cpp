@@ -24,3 +24,115 @@ TEST(GraphLinks, InvalidPorts)
 
   EXPECT_THROW(g.new_link(v, "does_not_exist", a, "a"), std::runtime_error);
 }
+
+TEST(Ports, Handles)
+{
+  gnode::Graph g;
+
+  auto  v = g.add_node<Value>(2.f);
+  auto  a = g.add_node<TypedAdd>();
+  auto *p_add = g.get_node_ref_by_id(a);
+
+  gnode::InPort<float>  in = p_add->add_port<float>(gnode::PortType::IN, "c");
+  gnode::OutPort<float> out = p_add->add_port<float>(gnode::PortType::OUT,
+                                                      "d",
+                                                      3.f);
+
+  // unconnected input
+  EXPECT_FALSE(in);
+  EXPECT_EQ(in.get(), nullptr);
+  EXPECT_FLOAT_EQ(*out, 3.f);
+
+  // same value as the port lookups
+  g.new_link(v, "value", a, "c");
+  ASSERT_TRUE(in);
+  EXPECT_EQ(in.get(), p_add->get_value_ref<float>("c"));
+  EXPECT_FLOAT_EQ(*in, 2.f);
+
+  *out = 4.f;
+  EXPECT_FLOAT_EQ(*p_add->get_value_ref<float>("d"), 4.f);
+
+  g.remove_link(v, "value", a, "c");
+  EXPECT_FALSE(in);
+
+  // wrong direction or type
+  using OutHandle = gnode::OutPort<float>;
+  using InHandle = gnode::InPort<int>;
+
+  EXPECT_THROW(OutHandle(p_add->add_port<float>(gnode::PortType::IN, "e")),
+               std::invalid_argument);
+  EXPECT_THROW(InHandle(p_add->add_port<int>(gnode::PortType::OUT, "f")),
+               std::invalid_argument);
+
+  // handles used by compute
+  g.new_link(v, "value", a, "a");
+  g.new_link(v, "value", a, "b");
+  g.update();
+  EXPECT_FLOAT_EQ(*p_add->get_value_ref<float>("a + b"), 4.f);
+}
+
+TEST(Ports, HandlesOutliveGraph)
+{
+  auto                 p_add = std::make_shared<Add>();
+  gnode::InPort<float> in = p_add->add_port<float>(gnode::PortType::IN, "c");
+
+  // inputs unbound by clear
+  {
+    gnode::Graph g;
+
+    auto v = g.add_node<Value>(2.f);
+    auto a = g.add_node(p_add, "add");
+
+    g.new_link(v, "value", a, "c");
+    ASSERT_TRUE(in);
+
+    g.clear();
+    EXPECT_FALSE(in);
+  }
+
+  // and by the destruction of the graph
+  {
+    gnode::Graph g;
+
+    auto v = g.add_node<Value>(2.f);
+    auto a = g.add_node(p_add, "add");
+
+    g.new_link(v, "value", a, "c");
+    ASSERT_TRUE(in);
+  }
+
+  EXPECT_FALSE(in);
+  EXPECT_EQ(in.get(), nullptr);
+}
+
+TEST(GraphLinks, TypeMismatch)
+{
+  gnode::Graph g;
+
+  auto  v = g.add_node<Value>();
+  auto  a = g.add_node<Add>();
+  auto *p_add = g.get_node_ref_by_id(a);
+
+  p_add->add_port<int>(gnode::PortType::IN, "count");
+
+  EXPECT_THROW(g.new_link(v, "value", a, "count"), std::invalid_argument);
+  EXPECT_TRUE(g.get_links().empty());
+  EXPECT_TRUE(g.new_link(v, "value", a, "a"));
+
+  // interned type identifiers and readable names
+  EXPECT_EQ(p_add->get_data_type_id(0), gnode::get_type_id<float>());
+  EXPECT_NE(p_add->get_data_type_id(3), gnode::get_type_id<float>());
+  EXPECT_EQ(p_add->get_data_type(3), "int");
+  EXPECT_EQ(gnode::get_type_name(gnode::get_type_id<int>()),
+            typeid(int).name());
+  EXPECT_EQ(gnode::get_type_pretty_name(gnode::get_type_id<std::string>()),
+            gnode::get_type_pretty_name(
+                gnode::intern_type(typeid(std::string))));
+
+  gnode::Data<float> f1(1.f), f2(2.f);
+  gnode::Data<int>   i1(1);
+
+  EXPECT_TRUE(f1.is_same_type(f2));
+  EXPECT_FALSE(f1.is_same_type(i1));
+  EXPECT_EQ(f1.get_type(), typeid(float).name());
+}